@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 
 /**
@@ -27,6 +28,7 @@
  *
  * @par Install
  * Copy vector.h file to your source code tree.
+ * Copy vector_arena.h file too if you use the arena allocator.
  *
  * @par How to use
  * Please see #vector_init and #vector_alloc in this document.
@@ -36,6 +38,52 @@
  *
  * @section history_sec History
  *
+ * @par Ver 0.4.0: not released yet
+ * @li Added #vector_set_growth_factor function
+ * @li Added #vector_set_growth_policy function
+ * @li Added #vector_ensure_capacity function
+ * @li Added #vector_reserve function
+ * @li Added #vector_flags function
+ * @li Added #vector_set_flags function
+ * @li Added #VECTOR_SENTINEL_ONLY flag
+ * @li Added #VECTOR_AUTO_SHRINK flag
+ * @li Added #vector_trim_to_size function
+ * @li Added #vector_insert_array function
+ * @li Added #vector_remove_range function
+ * @li Added #vector_swap_remove function
+ * @li Added #vector_append_n function
+ * @li Added #vector_detach function
+ * @li Added #vector_adopt function
+ * @li Added #vector_reserve_back function
+ * @li Added #vector_commit function
+ * @li Added arena allocator (vector_arena.h)
+ * @li Added #vector_create_with_allocator function
+ * @li Added #vector_create_compact function
+ * @li Added #vector_init_inplace function
+ * @li Added #vector_fini function
+ * @li Added #vector_init_small function
+ * @li Added #vector_set_alignment function
+ * @li Added #vector_alignment function
+ * @li Added #VECTOR_MMAP flag
+ * @li Added #VECTOR_HUGE_PAGES flag
+ * @li Added #vector_huge_pages function
+ * @li Vectorized #vector_index_of and #vector_contains
+ * @li Added #vector_index_of_from function
+ * @li Added #vector_last_index_of function
+ * @li Added #vector_find function
+ * @li Added #vector_find_from function
+ * @li Added #vector_rfind function
+ * @li Added #VECTOR_SORTED flag
+ * @li Added #vector_sort function
+ * @li Added #vector_lower_bound function
+ * @li Added #vector_binary_search function
+ * @li Added #vector_insert_sorted function
+ * @li Added #vector_enable_hash_index function
+ * @li Added #vector_disable_hash_index function
+ * @li Added #vector_has_hash_index function
+ * @li Changed #vector_set to return the previous element
+ * @li Fixed a memory leak when reallocation failed
+ *
  * @par Ver 0.3.1: April 7, 2013
  * @li Fixed a vector initialization bug
  *
@@ -68,6 +116,384 @@
  * incremental reallocation.
  */
 
+#if defined(__GNUC__)
+#define VECTOR_MAYBE_UNUSED __attribute__((unused))
+#else
+#define VECTOR_MAYBE_UNUSED
+#endif
+
+#if defined(__linux__)
+#include <stdio.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+#define VECTOR_HAS_MMAP 1
+#ifndef MREMAP_MAYMOVE
+#define MREMAP_MAYMOVE 1
+extern void *mremap(void *old_address, size_t old_size, size_t new_size, int flags, ...);
+#endif
+#ifndef MREMAP_FIXED
+#define MREMAP_FIXED 2
+#endif
+#else
+#define VECTOR_HAS_MMAP 0
+#endif
+
+/*
+ * Maps, remaps or unmaps anonymous memory like realloc.
+ * Returns NULL if new_size is zero, on failure, or on systems without mremap.
+ */
+static VECTOR_MAYBE_UNUSED void *vector_mmap_internal(void *ptr, size_t old_size, size_t new_size) {
+#if VECTOR_HAS_MMAP
+	void *result;
+	if (new_size == 0) {
+		munmap(ptr, old_size);
+		return NULL;
+	}
+	if (ptr == NULL) {
+		result = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	} else {
+		result = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE);
+	}
+	return result == MAP_FAILED ? NULL : result;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * Size of a huge page in bytes, which is also the alignment of the internal
+ * data array mapped by #VECTOR_HUGE_PAGES.
+ */
+#define VECTOR_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/*
+ * Same as vector_mmap_internal, but rounds sizes up to VECTOR_HUGE_PAGE_SIZE
+ * and places the mapping at a huge page boundary. A new mapping tries
+ * MAP_HUGETLB first, then falls back to normal pages with MADV_HUGEPAGE.
+ * Growth moves pages to an aligned address by mremap, or copies them if the
+ * kernel cannot move the mapping.
+ */
+static VECTOR_MAYBE_UNUSED void *vector_huge_mmap_internal(void *ptr, size_t old_size, size_t new_size) {
+#if VECTOR_HAS_MMAP
+	size_t mask = VECTOR_HUGE_PAGE_SIZE - 1;
+	char *reserved;
+	char *result;
+	old_size = (old_size + mask) & ~mask;
+	new_size = (new_size + mask) & ~mask;
+	if (new_size == 0) {
+		munmap(ptr, old_size);
+		return NULL;
+	}
+	if (ptr != NULL && new_size <= old_size) {
+		if (new_size < old_size) {
+			munmap((char *) ptr + new_size, old_size - new_size);
+		}
+		return ptr;
+	}
+	if (ptr != NULL && mremap(ptr, old_size, new_size, 0) != MAP_FAILED) {
+		result = (char *) ptr;
+	} else {
+#ifdef MAP_HUGETLB
+		if (ptr == NULL) {
+			result = (char *) mmap(NULL, new_size, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (result != MAP_FAILED) {
+				return result;
+			}
+		}
+#endif
+		reserved = (char *) mmap(NULL, new_size + mask, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (reserved == MAP_FAILED) {
+			return NULL;
+		}
+		result = reserved + (VECTOR_HUGE_PAGE_SIZE - (size_t) reserved % VECTOR_HUGE_PAGE_SIZE) % VECTOR_HUGE_PAGE_SIZE;
+		if (result != reserved) {
+			munmap(reserved, result - reserved);
+		}
+		if (result + new_size != reserved + new_size + mask) {
+			munmap(result + new_size, reserved + mask - result);
+		}
+		if (ptr != NULL && mremap(ptr, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, result) == MAP_FAILED) {
+			munmap(result, new_size);
+			result = (char *) vector_huge_mmap_internal(NULL, 0, new_size);
+			if (result == NULL) {
+				return NULL;
+			}
+			memcpy(result, ptr, old_size);
+			munmap(ptr, old_size);
+			return result;
+		}
+	}
+#ifdef MADV_HUGEPAGE
+	madvise(result, new_size, MADV_HUGEPAGE);
+#endif
+	return result;
+#else
+	return NULL;
+#endif
+}
+
+/*
+ * Returns the number of bytes backed by huge pages in the mapping that
+ * contains ptr, which is read from /proc/self/smaps. Returns zero if it is
+ * unknown.
+ */
+static VECTOR_MAYBE_UNUSED size_t vector_huge_pages_size_internal(const void *ptr) {
+#if VECTOR_HAS_MMAP
+	FILE *fp = fopen("/proc/self/smaps", "r");
+	char line[256];
+	unsigned long start, end, kb;
+	int found = 0;
+	size_t result = 0;
+	if (fp == NULL) {
+		return 0;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+			if (found) {
+				break;
+			}
+			found = start <= (unsigned long) ptr && (unsigned long) ptr < end;
+		} else if (found && (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1
+				|| sscanf(line, "Shared_Hugetlb: %lu kB", &kb) == 1
+				|| sscanf(line, "Private_Hugetlb: %lu kB", &kb) == 1)) {
+			result += (size_t) kb * 1024;
+		}
+	}
+	fclose(fp);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(VECTOR_NO_SIMD)
+#define VECTOR_HAS_SIMD 1
+#include <immintrin.h>
+#else
+#define VECTOR_HAS_SIMD 0
+#endif
+
+/*
+ * Kinds of search kernels, which are selected by the element type.
+ * Integers and pointers are compared bitwise by their size, and floating point
+ * numbers are compared by the same rules as the == operator.
+ */
+#define VECTOR_FIND_8 0
+#define VECTOR_FIND_16 1
+#define VECTOR_FIND_32 2
+#define VECTOR_FIND_64 3
+#define VECTOR_FIND_FLOAT 4
+#define VECTOR_FIND_DOUBLE 5
+#define VECTOR_FIND_KINDS 6
+
+/*
+ * Returns the search kernel kind of the element type, or -1 if elements have
+ * to be compared by the scalar loop.
+ */
+#if VECTOR_HAS_SIMD && defined(__cplusplus)
+extern "C++" {
+template <typename T> struct vector_find_kind_traits {
+	enum {
+		value = sizeof(T) == 1 ? VECTOR_FIND_8 : sizeof(T) == 2 ? VECTOR_FIND_16
+			: sizeof(T) == 4 ? VECTOR_FIND_32 : sizeof(T) == 8 ? VECTOR_FIND_64 : -1
+	};
+};
+template <> struct vector_find_kind_traits<float> { enum { value = VECTOR_FIND_FLOAT }; };
+template <> struct vector_find_kind_traits<double> { enum { value = VECTOR_FIND_DOUBLE }; };
+template <> struct vector_find_kind_traits<long double> { enum { value = -1 }; };
+}
+#define vector_find_kind_internal(type) ((int) vector_find_kind_traits<type>::value)
+#elif VECTOR_HAS_SIMD
+#define vector_find_kind_internal(type) \
+	(__builtin_types_compatible_p(type, float) ? VECTOR_FIND_FLOAT \
+	: __builtin_types_compatible_p(type, double) ? VECTOR_FIND_DOUBLE \
+	: __builtin_types_compatible_p(type, long double) ? -1 \
+	: sizeof(type) == 1 ? VECTOR_FIND_8 \
+	: sizeof(type) == 2 ? VECTOR_FIND_16 \
+	: sizeof(type) == 4 ? VECTOR_FIND_32 \
+	: sizeof(type) == 8 ? VECTOR_FIND_64 : -1)
+#else
+#define vector_find_kind_internal(type) -1
+#endif
+
+/*
+ * Search kernel that returns the index of the first (or last) element in
+ * array[0, n) that equals *key, or (size_t) -1 if no element equals it.
+ */
+typedef size_t (*vector_find_func)(const void *array, size_t n, const void *key);
+
+#if VECTOR_HAS_SIMD
+/*
+ * Defines the forward and backward search kernels that compare lanes elements
+ * at once. match gives a bit mask of the elements at p + i that equal the
+ * broadcast key kv, in which each element has bits bits.
+ */
+#define vector_find_kernel_internal(name, isa, elem, vec, set1, match, lanes, bits) \
+	static VECTOR_MAYBE_UNUSED __attribute__((target(isa))) \
+	size_t name##_internal(const void *array, size_t n, const void *key) { \
+		const elem *p = (const elem *) array; \
+		elem k = *(const elem *) key; \
+		vec kv = set1; \
+		size_t i = 0; \
+		for (; i + (lanes) <= n; i += (lanes)) { \
+			unsigned long long mask = (match); \
+			if (mask) { \
+				return i + __builtin_ctzll(mask) / (bits); \
+			} \
+		} \
+		for (; i < n; i++) { \
+			if (p[i] == k) { \
+				return i; \
+			} \
+		} \
+		return (size_t) -1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED __attribute__((target(isa))) \
+	size_t name##_last_internal(const void *array, size_t n, const void *key) { \
+		const elem *p = (const elem *) array; \
+		elem k = *(const elem *) key; \
+		vec kv = set1; \
+		size_t i = n; \
+		while (i >= (lanes)) { \
+			unsigned long long mask; \
+			i -= (lanes); \
+			mask = (match); \
+			if (mask) { \
+				return i + (63 - __builtin_clzll(mask)) / (bits); \
+			} \
+		} \
+		while (i > 0) { \
+			if (p[--i] == k) { \
+				return i; \
+			} \
+		} \
+		return (size_t) -1; \
+	}
+
+#define vector_sse2_match_internal(cmp) \
+	(unsigned int) _mm_movemask_epi8(cmp(_mm_loadu_si128((const __m128i *) (p + i)), kv))
+#define vector_avx2_match_internal(cmp) \
+	(unsigned int) _mm256_movemask_epi8(cmp(_mm256_loadu_si256((const __m256i *) (p + i)), kv))
+#define vector_avx512_match_internal(cmp) \
+	cmp(_mm512_loadu_si512((const void *) (p + i)), kv)
+
+/* SSE2 does not compare 64 bit integers, so both halves have to be equal */
+#define vector_sse2_cmpeq_epi64_internal(a, b) \
+	_mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_shuffle_epi32(_mm_cmpeq_epi32(a, b), 0xb1))
+#define vector_sse2_cmpeq_ps_internal(a, b) _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))
+#define vector_sse2_cmpeq_pd_internal(a, b) _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)))
+#define vector_avx2_cmpeq_ps_internal(a, b) \
+	_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))
+#define vector_avx2_cmpeq_pd_internal(a, b) \
+	_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ))
+#define vector_avx512_cmpeq_ps_internal(a, b) \
+	_mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ)
+#define vector_avx512_cmpeq_pd_internal(a, b) \
+	_mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_EQ_OQ)
+
+vector_find_kernel_internal(vector_find_sse2_8, "sse2", unsigned char, __m128i,
+		_mm_set1_epi8((char) k), vector_sse2_match_internal(_mm_cmpeq_epi8), 16, 1)
+vector_find_kernel_internal(vector_find_sse2_16, "sse2", unsigned short, __m128i,
+		_mm_set1_epi16((short) k), vector_sse2_match_internal(_mm_cmpeq_epi16), 8, 2)
+vector_find_kernel_internal(vector_find_sse2_32, "sse2", unsigned int, __m128i,
+		_mm_set1_epi32((int) k), vector_sse2_match_internal(_mm_cmpeq_epi32), 4, 4)
+vector_find_kernel_internal(vector_find_sse2_64, "sse2", unsigned long long, __m128i,
+		_mm_set1_epi64x((long long) k), vector_sse2_match_internal(vector_sse2_cmpeq_epi64_internal), 2, 8)
+vector_find_kernel_internal(vector_find_sse2_float, "sse2", float, __m128i,
+		_mm_castps_si128(_mm_set1_ps(k)), vector_sse2_match_internal(vector_sse2_cmpeq_ps_internal), 4, 4)
+vector_find_kernel_internal(vector_find_sse2_double, "sse2", double, __m128i,
+		_mm_castpd_si128(_mm_set1_pd(k)), vector_sse2_match_internal(vector_sse2_cmpeq_pd_internal), 2, 8)
+
+vector_find_kernel_internal(vector_find_avx2_8, "avx2", unsigned char, __m256i,
+		_mm256_set1_epi8((char) k), vector_avx2_match_internal(_mm256_cmpeq_epi8), 32, 1)
+vector_find_kernel_internal(vector_find_avx2_16, "avx2", unsigned short, __m256i,
+		_mm256_set1_epi16((short) k), vector_avx2_match_internal(_mm256_cmpeq_epi16), 16, 2)
+vector_find_kernel_internal(vector_find_avx2_32, "avx2", unsigned int, __m256i,
+		_mm256_set1_epi32((int) k), vector_avx2_match_internal(_mm256_cmpeq_epi32), 8, 4)
+vector_find_kernel_internal(vector_find_avx2_64, "avx2", unsigned long long, __m256i,
+		_mm256_set1_epi64x((long long) k), vector_avx2_match_internal(_mm256_cmpeq_epi64), 4, 8)
+vector_find_kernel_internal(vector_find_avx2_float, "avx2", float, __m256i,
+		_mm256_castps_si256(_mm256_set1_ps(k)), vector_avx2_match_internal(vector_avx2_cmpeq_ps_internal), 8, 4)
+vector_find_kernel_internal(vector_find_avx2_double, "avx2", double, __m256i,
+		_mm256_castpd_si256(_mm256_set1_pd(k)), vector_avx2_match_internal(vector_avx2_cmpeq_pd_internal), 4, 8)
+
+vector_find_kernel_internal(vector_find_avx512_8, "avx512f,avx512bw", unsigned char, __m512i,
+		_mm512_set1_epi8((char) k), vector_avx512_match_internal(_mm512_cmpeq_epi8_mask), 64, 1)
+vector_find_kernel_internal(vector_find_avx512_16, "avx512f,avx512bw", unsigned short, __m512i,
+		_mm512_set1_epi16((short) k), vector_avx512_match_internal(_mm512_cmpeq_epi16_mask), 32, 1)
+vector_find_kernel_internal(vector_find_avx512_32, "avx512f", unsigned int, __m512i,
+		_mm512_set1_epi32((int) k), vector_avx512_match_internal(_mm512_cmpeq_epi32_mask), 16, 1)
+vector_find_kernel_internal(vector_find_avx512_64, "avx512f", unsigned long long, __m512i,
+		_mm512_set1_epi64((long long) k), vector_avx512_match_internal(_mm512_cmpeq_epi64_mask), 8, 1)
+vector_find_kernel_internal(vector_find_avx512_float, "avx512f", float, __m512i,
+		_mm512_castps_si512(_mm512_set1_ps(k)), vector_avx512_match_internal(vector_avx512_cmpeq_ps_internal), 16, 1)
+vector_find_kernel_internal(vector_find_avx512_double, "avx512f", double, __m512i,
+		_mm512_castpd_si512(_mm512_set1_pd(k)), vector_avx512_match_internal(vector_avx512_cmpeq_pd_internal), 8, 1)
+#endif
+
+/*
+ * Returns the search kernel of specified kind for the running CPU, or NULL if
+ * elements have to be compared by the scalar loop. The kernels are selected
+ * once by cpuid.
+ */
+static VECTOR_MAYBE_UNUSED vector_find_func vector_find_func_internal(int kind, int last) {
+#if VECTOR_HAS_SIMD
+	static const vector_find_func sse2[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_sse2_8_internal, vector_find_sse2_16_internal, vector_find_sse2_32_internal,
+			vector_find_sse2_64_internal, vector_find_sse2_float_internal, vector_find_sse2_double_internal },
+		{ vector_find_sse2_8_last_internal, vector_find_sse2_16_last_internal, vector_find_sse2_32_last_internal,
+			vector_find_sse2_64_last_internal, vector_find_sse2_float_last_internal, vector_find_sse2_double_last_internal }
+	};
+	static const vector_find_func avx2[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_avx2_8_internal, vector_find_avx2_16_internal, vector_find_avx2_32_internal,
+			vector_find_avx2_64_internal, vector_find_avx2_float_internal, vector_find_avx2_double_internal },
+		{ vector_find_avx2_8_last_internal, vector_find_avx2_16_last_internal, vector_find_avx2_32_last_internal,
+			vector_find_avx2_64_last_internal, vector_find_avx2_float_last_internal, vector_find_avx2_double_last_internal }
+	};
+	static const vector_find_func avx512[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_avx512_8_internal, vector_find_avx512_16_internal, vector_find_avx512_32_internal,
+			vector_find_avx512_64_internal, vector_find_avx512_float_internal, vector_find_avx512_double_internal },
+		{ vector_find_avx512_8_last_internal, vector_find_avx512_16_last_internal, vector_find_avx512_32_last_internal,
+			vector_find_avx512_64_last_internal, vector_find_avx512_float_last_internal,
+			vector_find_avx512_double_last_internal }
+	};
+	/*
+	 * 0 until the first call has checked the CPU, then 1 + the index into
+	 * tables. Threads that race on the first call store the same value, and
+	 * the atomic accesses keep that race well defined.
+	 */
+	static const vector_find_func (*const tables[])[VECTOR_FIND_KINDS] = { NULL, sse2, avx2, avx512 };
+	static int selected = 0;
+	int isa = __atomic_load_n(&selected, __ATOMIC_RELAXED);
+	if (!isa) {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+			isa = 4;
+		} else if (__builtin_cpu_supports("avx2")) {
+			isa = 3;
+		} else if (__builtin_cpu_supports("sse2")) {
+			isa = 2;
+		} else {
+			isa = 1;
+		}
+		__atomic_store_n(&selected, isa, __ATOMIC_RELAXED);
+	}
+	if (kind < 0 || tables[isa - 1] == NULL) {
+		return NULL;
+	}
+	return tables[isa - 1][last != 0][kind];
+#else
+	(void) kind;
+	(void) last;
+	return NULL;
+#endif
+}
+
 /**
  * Memory allocator of this vector functions.
  * You have to implement this function in your source code like the following:
@@ -93,319 +519,1842 @@
  * same as ptr or a new location. Or a null pointer if systems does not enough
  * memory or size specified UINT_MAX
  * @see #vector_init
+ * @see #vector_arena_alloc
  */
 static void *vector_alloc(void *ptr, size_t size);
 
 /**
- * Create a new vector.
+ * Memory allocator of a vector that carries a context pointer.
+ * You can give each vector its own allocator like the following:
  *
- * @param [in] capacity capacity of a new vector.
- * vector capacity is one if specified capacity is zero
- * @param [in] capacity_increment the amount by which the capacity of the vector
- * is automatically incremented when its size becomes greater than its capacity.
- * If the capacity_increment is equal to zero, the capacity of the vector is
- * doubled each time it needs to grow
- * @return a pointer of new vector if the new vector was created, otherwise NULL
+ * @code
+ * static void *pool_alloc(void *context, void *ptr, size_t size) {
+ *     return my_pool_realloc((my_pool *) context, ptr, size);
+ * }
+ *
+ * static const vector_allocator pool_allocator = { pool_alloc };
+ *
+ * vector *v = vector_create_with_allocator(0, 0, &pool_allocator, &pool);
+ * @endcode
+ *
+ * @see #vector_create_with_allocator
  */
-#define vector_create(capacity, capacity_increment) \
-	vector_alloc_internal(NULL, capacity, capacity_increment)
+typedef struct {
+	/**
+	 * Same as #vector_alloc, but receives the context of the vector.
+	 */
+	void *(*alloc)(void *context, void *ptr, size_t size);
+} vector_allocator;
 
 /**
- * Destroy specified vector.
- *
- * @param [in,out] v specified vector
+ * Storage of the internal data array that is allocated by the allocator of
+ * the vector.
  */
-#define vector_destroy(v) \
-	if (v) vector_alloc(((vector *) v)->elements, UINT_MAX), vector_alloc(v, UINT_MAX)
+#define VECTOR_STORAGE_ALLOC 0
 
 /**
- * Returns the number of components in specified vector.
+ * Storage of the internal data array that is embedded in a memory block of
+ * the vector and is not released by itself.
+ */
+#define VECTOR_STORAGE_INLINE 1
+
+/**
+ * Storage of the internal data array that is aligned in a larger memory block
+ * allocated by the allocator of the vector.
+ */
+#define VECTOR_STORAGE_ALIGNED 2
+
+/**
+ * Storage of the internal data array that is mapped by mmap.
  *
- * @param [in] v specified vector
- * @return the number of components in specified vector
+ * @see #VECTOR_MMAP
  */
-#define vector_size(v) (v)->size
+#define VECTOR_STORAGE_MMAP 3
 
 /**
- * Returns the current capacity of specified vector.
+ * Storage of the internal data array that is mapped at a huge page boundary.
  *
- * @param [in] v specified vector
- * @return the current capacity (the length of its internal data array,
- * kept in the member elements of specified vector)
+ * @see #VECTOR_HUGE_PAGES
  */
-#define vector_capacity(v) (v)->capacity
+#define VECTOR_STORAGE_HUGE_PAGES 4
 
 /**
- * Appends the specified element to the end of specified vector.
+ * Flag of a vector that stops filling unused capacity with the invalid value.
+ * Only the element at the position of the vector size holds the invalid value,
+ * and the rest of the internal data array beyond it is left uninitialized when
+ * the vector grows. Growth does not touch memory that is not used yet.
  *
- * This function fails in the following cases:
- * @li the specified element is invalid value
- * @li does not enough memory
+ * @see #vector_set_flags
+ */
+#define VECTOR_SENTINEL_ONLY 0x01
+
+/**
+ * Flag of a vector that releases unused capacity automatically.
+ * When the vector size falls below a quarter of its capacity by removing
+ * components, the capacity is reduced to twice the size. The gap between the
+ * thresholds for growing and shrinking keeps the vector from reallocating
+ * repeatedly when components are added and removed around a boundary.
  *
- * @param [in,out] v specified vector
- * @param [in] element element to be appended to specified vector
- * @return true if the specified element was appended, otherwise false
+ * @see #vector_set_flags
  */
-#define vector_add(v, element) vector_insert(v, (v)->size, element)
+#define VECTOR_AUTO_SHRINK 0x02
 
 /**
- * Inserts the specified element at the specified position in specified vector.
- * Shifts the element currently at that position (if any)
- * and any subsequent elements to the right (adds one to their indices).
+ * Flag of a vector that maps its internal data array by mmap when the array
+ * is #VECTOR_MMAP_THRESHOLD bytes or more. Such an array grows and shrinks by
+ * mremap, which moves pages instead of copying components, so the growth of a
+ * huge vector does not take time in proportion to its size. The array moves
+ * back to the allocator of the vector when it shrinks below the threshold.
+ * This flag is ignored on systems other than Linux, and when the alignment of
+ * the vector is greater than 4096 bytes.
  *
- * This function fails in the following cases:
- * @li the specified element is invalid value
- * @li the specified index is out of range (index < 0 || index > vector_size(v))
- * @li does not enough memory
+ * Pages that are not used yet are not touched with #VECTOR_SENTINEL_ONLY.
  *
- * @param [in,out] v specified vector
- * @param [in] index index at which the specified element is to be inserted
- * @param [in] element element to be inserted
- * @return true if the specified element was appended, otherwise false
+ * @see #vector_set_flags
  */
-#define vector_insert(v, index, element) vector_insert_internal(v, index, element)
+#define VECTOR_MMAP 0x04
 
 /**
- * Replaces the element at the specified position in specified vector with the
- * specified element.
+ * Flag of a vector that maps its internal data array at a huge page boundary
+ * when the array is #VECTOR_HUGE_PAGES_THRESHOLD bytes or more. The array is
+ * backed by MAP_HUGETLB pages if the system has reserved them, otherwise the
+ * kernel is advised by MADV_HUGEPAGE to back it by transparent huge pages.
+ * Huge pages reduce TLB misses when a large vector is accessed randomly.
+ * Like #VECTOR_MMAP, the array grows and shrinks by mremap. The mapping is
+ * rounded up to a multiple of #VECTOR_HUGE_PAGE_SIZE.
+ * This flag takes precedence over #VECTOR_MMAP: an array mapped by
+ * #VECTOR_MMAP is copied to huge pages once it reaches the threshold, and it
+ * moves back when it shrinks below the threshold. This flag is ignored on
+ * systems other than Linux, and when the alignment of the vector is greater
+ * than #VECTOR_HUGE_PAGE_SIZE.
  *
- * @param [in,out] v specified vector
- * @param [in] index index of the element to replace
- * @param [in] element element to be stored at the specified position
- * @return the element previously at the specified position
+ * The kernel may still back the array by normal pages. You can check it by
+ * #vector_huge_pages.
+ *
+ * @see #vector_set_flags
  */
-#define vector_set(v, index, element) (v)->elements[index] = element
+#define VECTOR_HUGE_PAGES 0x08
 
 /**
- * Removes the element at the specified position in specified vector.
- * Shifts any subsequent elements to the left (subtracts one from their
- * indices). Returns the element that was removed from the vector.
+ * Flag of a vector whose components are sorted in ascending order by the <
+ * operator. #vector_sort sets this flag, and #vector_index_of, #vector_find
+ * and the other search functions use binary search while it is set.
+ * #vector_insert_sorted and removal keep the order. Other functions that may
+ * break the order clear this flag, except #vector_insert and #vector_add that
+ * clear it only when the new element is out of order.
  *
- * @param [in,out] v specified vector
- * @param [in] index the index of the element to be removed
- * @return element that was removed
+ * If you modify the internal data array directly, you have to clear this flag
+ * by #vector_set_flags. The vector is not sorted correctly if it contains NaN.
+ *
+ * @see #vector_set_flags
  */
-#define vector_remove(v, index) vector_remove_internal(v, index)
+#define VECTOR_SORTED 0x10
 
+#ifndef VECTOR_HUGE_PAGES_THRESHOLD
 /**
- * Returns the element at the specified position in specified vector.
+ * Size of the internal data array in bytes from which #VECTOR_HUGE_PAGES maps
+ * it. You can define this macro before including vector.h.
+ */
+#define VECTOR_HUGE_PAGES_THRESHOLD VECTOR_HUGE_PAGE_SIZE
+#endif
+
+#ifndef VECTOR_MMAP_THRESHOLD
+/**
+ * Size of the internal data array in bytes from which #VECTOR_MMAP maps it.
+ * You can define this macro before including vector.h.
+ */
+#define VECTOR_MMAP_THRESHOLD (64 * 1024 * 1024)
+#endif
+
+#ifndef VECTOR_DEFAULT_FLAGS
+/**
+ * Flags of a new vector.
+ * You can define this macro before including vector.h like the following:
  *
- * @param [in] v specified vector
- * @param [in] index index of the element to return
- * @return element at the specified index
+ * @code
+ * #define VECTOR_DEFAULT_FLAGS VECTOR_SENTINEL_ONLY
+ * #include "vector.h"
+ * @endcode
+ *
+ * @see #vector_set_flags
  */
-#define vector_get(v, index) (v)->elements[index]
+#define VECTOR_DEFAULT_FLAGS 0
+#endif
 
 /**
- * Tests if specified vector has no components.
+ * Growth policy of a vector.
+ * You can implement this function in your source code like the following:
  *
- * @param [in] v specified vector
- * @return true if and only if specified vector has no components,
- * that is, its size is zero; false otherwise
+ * @code
+ * static size_t grow_by_quarter(size_t capacity, size_t min_capacity) {
+ *     return capacity + capacity / 4;
+ * }
+ * @endcode
+ *
+ * The vector capacity becomes min_capacity if this function returns a value
+ * less than min_capacity.
+ *
+ * @param [in] capacity the current capacity of the vector
+ * @param [in] min_capacity the minimum capacity that the vector needs
+ * @return the new capacity of the vector
+ * @see #vector_set_growth_policy
  */
-#define vector_is_empty(v) vector_size(v) == 0
+typedef size_t (*vector_growth_func)(size_t capacity, size_t min_capacity);
 
 /**
- * Returns the index of the first occurrence of the specified element in
- * specified vector, or -1 if specified vector does not contain the element.
+ * Create a new vector.
  *
- * @param [in] v specified vector
- * @param [in] element element to search for
- * @return the index of the first occurrence of the specified element in
- * specified vector, or -1 if specified vector does not contain the element or
- * specified vector size more than INT_MAX
+ * @param [in] capacity capacity of a new vector.
+ * vector capacity is one if specified capacity is zero
+ * @param [in] capacity_increment the amount by which the capacity of the vector
+ * is automatically incremented when its size becomes greater than its capacity.
+ * If the capacity_increment is equal to zero, the capacity of the vector is
+ * doubled each time it needs to grow
+ * @return a pointer of new vector if the new vector was created, otherwise NULL
  */
-#define vector_index_of(v, element) vector_index_of_internal(v, element)
+#define vector_create(capacity, capacity_increment) \
+	vector_create_internal(capacity, capacity_increment, NULL, NULL)
 
 /**
- * Returns true if specified vector contains the specified element.
+ * Create a new vector whose internal data array is placed just after the
+ * vector in a single memory block. A vector that never grows beyond the
+ * specified capacity costs only one allocation and is released by one.
  *
- * @param [in] v specified vector
- * @param [in] element element whose presence in specified vector is to be
- * tested
- * @return true if specified vector contains the specified element
+ * The vector cannot move when it grows, because the caller holds a pointer to
+ * it. The internal data array is moved to a separate memory block when the
+ * vector grows beyond the specified capacity, and the embedded one stays
+ * unused until the vector is destroyed.
+ *
+ * @param [in] capacity capacity of a new vector.
+ * vector capacity is one if specified capacity is zero
+ * @param [in] capacity_increment the amount by which the capacity of the vector
+ * is automatically incremented when its size becomes greater than its capacity.
+ * If the capacity_increment is equal to zero, the capacity of the vector is
+ * doubled each time it needs to grow
+ * @return a pointer of new vector if the new vector was created, otherwise NULL
  */
-#define vector_contains(v, element) vector_index_of(v, element) != -1
+#define vector_create_compact(capacity, capacity_increment) \
+	vector_create_compact_internal(capacity, capacity_increment)
 
 /**
- * Removes all of the elements from specified vector.
- * The vector will be empty after this call returns (unless it throws an
- * exception).
+ * Create a new vector that allocates memory by the specified allocator instead
+ * of #vector_alloc. The vector itself, its internal data array and its hash
+ * index are allocated and released by the allocator, and so is the extension
+ * that holds the allocator and the other settings of the vector.
  *
- * @param [in,out] v specified vector
+ * @param [in] capacity capacity of a new vector.
+ * vector capacity is one if specified capacity is zero
+ * @param [in] capacity_increment the amount by which the capacity of the vector
+ * is automatically incremented when its size becomes greater than its capacity.
+ * If the capacity_increment is equal to zero, the capacity of the vector is
+ * doubled each time it needs to grow
+ * @param [in] allocator the allocator of a new vector.
+ * #vector_alloc is used if allocator is NULL
+ * @param [in] context the context passed to the allocator
+ * @return a pointer of new vector if the new vector was created, otherwise NULL
+ * @see #vector_allocator
  */
-#define vector_clear(v) vector_clear_internal(v)
+#define vector_create_with_allocator(capacity, capacity_increment, allocator, context) \
+	vector_create_internal(capacity, capacity_increment, allocator, context)
 
 /**
- * Returns an array containing all of the elements in specified vector in the
- * correct order.
+ * Sets the growth factor of specified vector.
+ * The capacity of the vector is multiplied by factor each time it needs to
+ * grow, instead of being incremented by capacity_increment. The amount of
+ * each growth is clamped to the range from min_step to max_step.
  *
- * Element that position is vector size is always invalid value. For example,
- * the following sample code is valid.
+ * For example, the following vector grows 1.5 times each time, by at least 16
+ * and at most 1048576 elements:
  *
  * @code
- * vector_init(unsigned char, '\0');
- * vector *v = vector_create(3, 1);
- * vector_add(v, 'a');
- * vector_add(v, 'b');
- * vector_add(v, 'c');
- * printf("%s\n", vector_to_array(v));
+ * vector *v = vector_create(0, 0);
+ * vector_set_growth_factor(v, 1.5, 16, 1024 * 1024);
  * @endcode
  *
- * @param [in] v specified vector
- * @return an array containing all of the elements in this collection, or NULL
- * if systems does not enough memory
+ * @param [in,out] v specified vector
+ * @param [in] factor the growth factor. capacity_increment of specified vector
+ * is used if factor is not greater than 1.0
+ * @param [in] min_step the minimum amount of each growth.
+ * The amount is at least one if min_step is zero
+ * @param [in] max_step the maximum amount of each growth.
+ * The amount is unlimited if max_step is zero
+ * @return true if the growth factor was set, or false if systems does not
+ * have enough memory for the settings
  */
-#define vector_to_array(v) vector_to_array_internal(v)
+#define vector_set_growth_factor(v, factor, min_step, max_step) \
+	vector_set_growth_factor_internal(v, factor, min_step, max_step)
 
 /**
- * Appends the vector representation of the type array argument to specified vector.
+ * Sets the growth policy of specified vector.
+ * The policy takes precedence over the growth factor and capacity_increment.
  *
  * @param [in,out] v specified vector
- * @param [in] array the type array to be appended.
- * This array MUST be terminated invalid value of specified vector
- * @return a appended vector that is v
+ * @param [in] policy the growth policy, or NULL to use the growth factor and
+ * capacity_increment of specified vector
+ * @return true if the growth policy was set, or false if systems does not
+ * have enough memory for the settings
+ * @see #vector_growth_func
  */
-#define vector_append(v, array) vector_append_internal(v, array)
+#define vector_set_growth_policy(v, policy) vector_set_growth_policy_internal(v, policy)
 
 /**
- * Concatenates the v_from vector to the end of v_to vector.
+ * Returns the flags of specified vector.
  *
- * @param [in,out] v_to specified vector
- * @param [in] v_from the vector that is concatenated to the end of specified vector
- * @return a concatenated vector that is v_to
+ * @param [in] v specified vector
+ * @return the flags of specified vector
+ * @see #vector_set_flags
  */
-#define vector_concat(v_to, v_from) vector_concat_internal(v_to, v_from)
+#define vector_flags(v) (v)->flags
 
 /**
- * Initialize functions of specified type vector.
- *
- * You have to write in your source code like the following:
+ * Sets the flags of specified vector.
  *
- * @code
- * #include "vector.h"
+ * The following flags are available:
+ * @li #VECTOR_SENTINEL_ONLY
+ * @li #VECTOR_AUTO_SHRINK
+ * @li #VECTOR_MMAP
+ * @li #VECTOR_HUGE_PAGES
+ * @li #VECTOR_SORTED
  *
- * vector_init(int, UINT_MAX);
- * @endcode
+ * @param [in,out] v specified vector
+ * @param [in] new_flags bitwise OR of the flags
+ */
+#define vector_set_flags(v, new_flags) (v)->flags = (new_flags)
+
+/**
+ * Destroy specified vector.
  *
- * Or:
+ * @param [in,out] v specified vector
+ */
+#define vector_destroy(v) vector_destroy_internal(v)
+
+/**
+ * Initialize a vector that is embedded in another object or placed on the
+ * stack, instead of creating a new one. Only the internal data array is
+ * allocated.
  *
  * @code
- * #include "vector.h"
- *
- * vector_init(char *, NULL);
+ * vector v;
+ * if (vector_init_inplace(&v, 16, 0)) {
+ *     vector_add(&v, 123);
+ *     ...
+ *     vector_fini(&v);
+ * }
  * @endcode
  *
- * @param [in] type type of variable for vector elements
- * @param [in] invalid invalid value for vector. All vector objects never have
- * this element
- * @see #vector_alloc
- */
-#define vector_init(type, invalid) \
-	typedef struct { \
-		size_t size; \
-		size_t capacity; \
-		size_t capacity_increment; \
-		type *elements; \
+ * @param [out] v the vector to be initialized
+ * @param [in] capacity capacity of the vector.
+ * vector capacity is one if specified capacity is zero
+ * @param [in] capacity_increment the amount by which the capacity of the vector
+ * is automatically incremented when its size becomes greater than its capacity.
+ * If the capacity_increment is equal to zero, the capacity of the vector is
+ * doubled each time it needs to grow
+ * @return true if the vector was initialized, otherwise false
+ * @see #vector_fini
+ */
+#define vector_init_inplace(v, capacity, capacity_increment) \
+	vector_init_inplace_internal(v, capacity, capacity_increment)
+
+/**
+ * Releases the internal data array of a vector that was initialized by
+ * #vector_init_inplace. The vector itself is not released.
+ * The vector has no internal data array afterwards, so using it with any
+ * other function is undefined until it is initialized again by
+ * #vector_init_inplace.
+ *
+ * @param [in,out] v specified vector
+ */
+#define vector_fini(v) vector_fini_internal(v)
+
+/**
+ * Returns the number of components in specified vector.
+ *
+ * @param [in] v specified vector
+ * @return the number of components in specified vector
+ */
+#define vector_size(v) (v)->size
+
+/**
+ * Returns the current capacity of specified vector.
+ *
+ * @param [in] v specified vector
+ * @return the current capacity (the length of its internal data array,
+ * kept in the member elements of specified vector)
+ */
+#define vector_capacity(v) (v)->capacity
+
+/**
+ * Increases the capacity of specified vector, if necessary, to ensure that it
+ * is at least min_capacity. The internal data array is reallocated at most once,
+ * exactly to min_capacity, regardless of the growth policy of the vector.
+ *
+ * Note that the internal data array always contains the invalid value at the
+ * position of the vector size, so the vector can hold min_capacity - 1
+ * components without reallocation after this call.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] min_capacity the desired minimum capacity
+ * @return true if the capacity of specified vector is at least min_capacity,
+ * otherwise false (does not enough memory)
+ */
+#define vector_ensure_capacity(v, min_capacity) vector_ensure_capacity_internal(v, min_capacity)
+
+/**
+ * Reserves room for n more components in specified vector.
+ * The internal data array is reallocated at most once.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] n the number of components to be added
+ * @return true if n components can be added to specified vector without
+ * reallocation, otherwise false (does not enough memory)
+ * @see #vector_ensure_capacity
+ */
+#define vector_reserve(v, n) vector_ensure_capacity(v, (v)->size + (n) + 1)
+
+/**
+ * Reserves n slots at the end of specified vector and returns a pointer to
+ * them. The caller can write components into the slots directly, and then
+ * publish them by #vector_commit. The vector size is not changed by this
+ * function.
+ *
+ * @code
+ * char *buffer = vector_reserve_back(v, 4096);
+ * ssize_t n = read(fd, buffer, 4096);
+ * if (n > 0) {
+ *     vector_commit(v, n);
+ * }
+ * @endcode
+ *
+ * The returned pointer is invalidated by any other function that modifies
+ * specified vector.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] n the number of slots to be reserved
+ * @return a pointer to the first reserved slot, or NULL if systems does not
+ * enough memory
+ */
+#define vector_reserve_back(v, n) vector_reserve_back_internal(v, n)
+
+/**
+ * Appends the first n slots reserved by #vector_reserve_back to specified
+ * vector. The invalid value is written only once, after the last committed
+ * component.
+ *
+ * This function fails in the following cases:
+ * @li n is greater than the number of slots following the last component
+ *
+ * @param [in,out] v specified vector
+ * @param [in] n the number of components to be appended.
+ * The components MUST NOT contain invalid value of specified vector
+ * @return true if the components were appended, otherwise false
+ */
+#define vector_commit(v, n) vector_commit_internal(v, n)
+
+/**
+ * Trims the capacity of specified vector to be the vector's current size.
+ * An application can use this operation to minimize the storage of a vector.
+ *
+ * @param [in,out] v specified vector
+ */
+#define vector_trim_to_size(v) vector_trim_to_size_internal(v)
+
+/**
+ * Guarantees the alignment of the internal data array of specified vector.
+ * The internal data array is moved to an aligned memory block if it is not
+ * aligned, and it is always placed at the alignment after the vector grows or
+ * shrinks. The reallocation copies the components because realloc does not
+ * keep the alignment.
+ *
+ * For example, the following vector is suitable for AVX-512 aligned loads:
+ *
+ * @code
+ * vector *v = vector_create(1024, 0);
+ * vector_set_alignment(v, 64);
+ * @endcode
+ *
+ * This function fails in the following cases:
+ * @li alignment is not a power of two or zero
+ * @li does not enough memory
+ *
+ * @param [in,out] v specified vector
+ * @param [in] alignment the alignment in bytes, or zero to stop guaranteeing
+ * alignment
+ * @return true if the alignment was set, otherwise false
+ * @see #vector_alignment
+ */
+#define vector_set_alignment(v, alignment) vector_set_alignment_internal(v, alignment)
+
+/**
+ * Returns the actual alignment of the internal data array of specified vector,
+ * that is the largest power of two which divides its address.
+ *
+ * @param [in] v specified vector
+ * @return the alignment of the internal data array in bytes
+ * @see #vector_set_alignment
+ */
+#define vector_alignment(v) vector_alignment_internal(v)
+
+/**
+ * Returns the number of bytes of the internal data array of specified vector
+ * that are actually backed by huge pages. Transparent huge pages are
+ * allocated when the pages are touched first, so this function should be
+ * called after the vector is filled. This function reads /proc/self/smaps and
+ * is not fast.
+ *
+ * @param [in] v specified vector
+ * @return the number of bytes backed by huge pages, or zero if the internal
+ * data array is not mapped by #VECTOR_HUGE_PAGES
+ * @see #VECTOR_HUGE_PAGES
+ */
+#define vector_huge_pages(v) vector_huge_pages_internal(v)
+
+/**
+ * Appends the specified element to the end of specified vector.
+ *
+ * This function fails in the following cases:
+ * @li the specified element is invalid value
+ * @li does not enough memory
+ *
+ * @param [in,out] v specified vector
+ * @param [in] element element to be appended to specified vector
+ * @return true if the specified element was appended, otherwise false
+ */
+#define vector_add(v, element) vector_insert(v, (v)->size, element)
+
+/**
+ * Inserts the specified element at the specified position in specified vector.
+ * Shifts the element currently at that position (if any)
+ * and any subsequent elements to the right (adds one to their indices).
+ *
+ * This function fails in the following cases:
+ * @li the specified element is invalid value
+ * @li the specified index is out of range (index < 0 || index > vector_size(v))
+ * @li does not enough memory
+ *
+ * @param [in,out] v specified vector
+ * @param [in] index index at which the specified element is to be inserted
+ * @param [in] element element to be inserted
+ * @return true if the specified element was appended, otherwise false
+ */
+#define vector_insert(v, index, element) vector_insert_internal(v, index, element)
+
+/**
+ * Inserts n elements of the specified array at the specified position in
+ * specified vector. Shifts the element currently at that position (if any)
+ * and any subsequent elements to the right (adds n to their indices).
+ * The vector grows at most once, and the elements are shifted at once.
+ *
+ * This function fails in the following cases:
+ * @li the specified index is out of range (index < 0 || index > vector_size(v))
+ * @li does not enough memory
+ *
+ * @param [in,out] v specified vector
+ * @param [in] index index at which the first element of the array is to be
+ * inserted
+ * @param [in] array the elements to be inserted.
+ * This array MUST NOT contain invalid value of specified vector, and MUST NOT
+ * overlap with the internal data array of specified vector
+ * @param [in] n the number of elements to be inserted
+ * @return true if the elements were inserted, otherwise false
+ */
+#define vector_insert_array(v, index, array, n) vector_insert_array_internal(v, index, array, n)
+
+/**
+ * Replaces the element at the specified position in specified vector with the
+ * specified element.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] index index of the element to replace
+ * @param [in] element element to be stored at the specified position
+ * @return the element previously at the specified position
+ */
+#define vector_set(v, index, element) vector_set_internal(v, index, element)
+
+/**
+ * Removes the element at the specified position in specified vector.
+ * Shifts any subsequent elements to the left (subtracts one from their
+ * indices). Returns the element that was removed from the vector.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] index the index of the element to be removed
+ * @return element that was removed
+ */
+#define vector_remove(v, index) vector_remove_internal(v, index)
+
+/**
+ * Removes the element at the specified position in specified vector in
+ * constant time. The last element of the vector is moved to the position,
+ * so the order of elements is not preserved. Returns the element that was
+ * removed from the vector.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] index the index of the element to be removed
+ * @return element that was removed
+ */
+#define vector_swap_remove(v, index) vector_swap_remove_internal(v, index)
+
+/**
+ * Removes from specified vector all of the elements whose index is between
+ * from, inclusive, and to, exclusive. Shifts any succeeding elements to the
+ * left (reduces their index) at once.
+ *
+ * This function fails in the following cases:
+ * @li the specified range is out of range (from > to || to > vector_size(v))
+ *
+ * @param [in,out] v specified vector
+ * @param [in] from index of first element to be removed
+ * @param [in] to index after last element to be removed
+ * @return true if the elements were removed, otherwise false
+ */
+#define vector_remove_range(v, from, to) vector_remove_range_internal(v, from, to)
+
+/**
+ * Returns the element at the specified position in specified vector.
+ *
+ * @param [in] v specified vector
+ * @param [in] index index of the element to return
+ * @return element at the specified index
+ */
+#define vector_get(v, index) (v)->elements[index]
+
+/**
+ * Tests if specified vector has no components.
+ *
+ * @param [in] v specified vector
+ * @return true if and only if specified vector has no components,
+ * that is, its size is zero; false otherwise
+ */
+#define vector_is_empty(v) (vector_size(v) == 0)
+
+/**
+ * Returns the index of the first occurrence of the specified element in
+ * specified vector, or -1 if specified vector does not contain the element.
+ *
+ * The search compares 16 to 64 bytes at once by SSE2, AVX2 or AVX-512 that is
+ * selected at runtime, when the element type is an integer, a pointer, float
+ * or double on x86 with GCC compatible compilers. Other element types are
+ * compared one by one. You can disable the vectorized search by defining
+ * VECTOR_NO_SIMD before including vector.h.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the first occurrence of the specified element in
+ * specified vector, or -1 if specified vector does not contain the element in
+ * the first INT_MAX components
+ * @see #vector_find
+ */
+#define vector_index_of(v, element) vector_index_of_internal(v, element)
+
+/**
+ * Returns the index of the first occurrence of the specified element in
+ * specified vector, searching forwards from start, or -1 if the element is not
+ * found. Like #vector_index_of, the search is vectorized.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @param [in] start index to start searching from
+ * @return the index of the first occurrence of the specified element at or
+ * after start, or -1 if the element is not found in the first INT_MAX
+ * components
+ * @see #vector_find_from
+ */
+#define vector_index_of_from(v, element, start) vector_index_of_from_internal(v, element, start)
+
+/**
+ * Returns the index of the last occurrence of the specified element in
+ * specified vector, or -1 if specified vector does not contain the element.
+ * The search runs backwards from the end, so recent components of an appended
+ * vector are found first. Like #vector_index_of, the search is vectorized.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the last occurrence of the specified element in
+ * specified vector, or -1 if specified vector does not contain the element in
+ * the first INT_MAX components
+ * @see #vector_rfind
+ */
+#define vector_last_index_of(v, element) vector_last_index_of_internal(v, element)
+
+/**
+ * Index returned by #vector_find, #vector_find_from and #vector_rfind when
+ * the element is not found.
+ */
+#define VECTOR_NPOS ((size_t) -1)
+
+/**
+ * Returns the index of the first occurrence of the specified element in
+ * specified vector, or #VECTOR_NPOS if specified vector does not contain the
+ * element. Unlike #vector_index_of, this function searches all components of
+ * a vector that has more than INT_MAX components.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the first occurrence of the specified element in
+ * specified vector, or #VECTOR_NPOS if specified vector does not contain the
+ * element
+ */
+#define vector_find(v, element) vector_find_from_internal(v, element, 0)
+
+/**
+ * Returns the index of the first occurrence of the specified element in
+ * specified vector, searching forwards from start, or #VECTOR_NPOS if the
+ * element is not found. This is the size_t version of #vector_index_of_from.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @param [in] start index to start searching from
+ * @return the index of the first occurrence of the specified element at or
+ * after start, or #VECTOR_NPOS if the element is not found
+ */
+#define vector_find_from(v, element, start) vector_find_from_internal(v, element, start)
+
+/**
+ * Returns the index of the last occurrence of the specified element in
+ * specified vector, or #VECTOR_NPOS if specified vector does not contain the
+ * element. This is the size_t version of #vector_last_index_of.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the last occurrence of the specified element in
+ * specified vector, or #VECTOR_NPOS if specified vector does not contain the
+ * element
+ */
+#define vector_rfind(v, element) vector_rfind_internal(v, element)
+
+/**
+ * Sorts the components of specified vector in ascending order by the <
+ * operator, and sets #VECTOR_SORTED to specified vector.
+ * The sort is done by qsort and is not stable.
+ *
+ * @param [in,out] v specified vector
+ * @see #VECTOR_SORTED
+ */
+#define vector_sort(v) vector_sort_internal(v)
+
+/**
+ * Returns the index of the first component in specified vector that is not
+ * less than the specified element. Specified vector MUST be sorted.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the first component not less than the specified
+ * element, or the vector size if there is no such component
+ */
+#define vector_lower_bound(v, element) vector_lower_bound_internal(v, element)
+
+/**
+ * Returns the index of the first occurrence of the specified element in
+ * specified vector by binary search. Specified vector MUST be sorted.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element to search for
+ * @return the index of the first occurrence of the specified element, or
+ * #VECTOR_NPOS if specified vector does not contain the element
+ */
+#define vector_binary_search(v, element) vector_binary_search_internal(v, element)
+
+/**
+ * Inserts the specified element into specified vector at the position found
+ * by binary search, after the components equal to it, so that the vector stays
+ * sorted. Specified vector MUST be sorted. The tail is shifted by memmove.
+ *
+ * This function fails in the following cases:
+ * @li does not enough memory
+ * @li specified element equals to the invalid value
+ *
+ * @param [in,out] v specified vector
+ * @param [in] element element to be inserted
+ * @return true if the element was inserted, otherwise false
+ */
+#define vector_insert_sorted(v, element) vector_insert_sorted_internal(v, element)
+
+/**
+ * Builds a hash index of specified vector that maps each component to its
+ * position, so that #vector_index_of, #vector_contains, #vector_find and the
+ * other search functions take constant time instead of scanning the vector.
+ * The order of the components does not change.
+ *
+ * The index is an open addressing table allocated by the allocator of the
+ * vector, and it is kept current by the functions that modify the vector.
+ * Appending, #vector_set and #vector_swap_remove update it in constant time,
+ * while inserting or removing in the middle updates the positions of the
+ * shifted components. Bulk operations rebuild it. If memory runs out while
+ * the index grows, the index is dropped and searches scan the vector again.
+ *
+ * Components are hashed by their bytes, so the element type MUST NOT have
+ * padding bits, such as long double. If you modify the internal data array
+ * directly, you have to disable the index.
+ *
+ * @param [in,out] v specified vector
+ * @return true if the index was built, otherwise false
+ * @see #vector_disable_hash_index
+ */
+#define vector_enable_hash_index(v) vector_enable_hash_index_internal(v)
+
+/**
+ * Releases the hash index of specified vector built by
+ * #vector_enable_hash_index.
+ *
+ * @param [in,out] v specified vector
+ */
+#define vector_disable_hash_index(v) vector_disable_hash_index_internal(v)
+
+/**
+ * Returns true if specified vector has a hash index.
+ *
+ * @param [in] v specified vector
+ * @return true if specified vector has a hash index
+ * @see #vector_enable_hash_index
+ */
+#define vector_has_hash_index(v) ((v)->extension != NULL && (v)->extension->hash_index != NULL)
+
+/**
+ * Returns true if specified vector contains the specified element.
+ * All components are searched even if the vector size is more than INT_MAX.
+ *
+ * @param [in] v specified vector
+ * @param [in] element element whose presence in specified vector is to be
+ * tested
+ * @return true if specified vector contains the specified element
+ */
+#define vector_contains(v, element) (vector_find(v, element) != VECTOR_NPOS)
+
+/**
+ * Removes all of the elements from specified vector.
+ * The vector will be empty after this call returns (unless it throws an
+ * exception).
+ * This function takes constant time; only the first element of the internal
+ * data array is overwritten with the invalid value, and the rest keeps the old
+ * components.
+ *
+ * @param [in,out] v specified vector
+ */
+#define vector_clear(v) vector_clear_internal(v)
+
+/**
+ * Returns an array containing all of the elements in specified vector in the
+ * correct order.
+ *
+ * Element that position is vector size is always invalid value. For example,
+ * the following sample code is valid.
+ *
+ * @code
+ * vector_init(unsigned char, '\0');
+ * vector *v = vector_create(3, 1);
+ * vector_add(v, 'a');
+ * vector_add(v, 'b');
+ * vector_add(v, 'c');
+ * printf("%s\n", vector_to_array(v));
+ * @endcode
+ *
+ * @param [in] v specified vector
+ * @return an array containing all of the elements in this collection, or NULL
+ * if systems does not enough memory
+ */
+#define vector_to_array(v) vector_to_array_internal(v)
+
+/**
+ * Takes the internal data array away from specified vector without copying.
+ * Specified vector becomes empty and gets a new internal data array of
+ * capacity one. The components are copied to a new array if the internal data
+ * array is not allocated by the allocator of the vector as it is, that is the
+ * array is embedded in the vector (see #vector_create_compact and
+ * #vector_init_small), aligned (see #vector_set_alignment) or mapped (see
+ * #VECTOR_MMAP and #VECTOR_HUGE_PAGES). An aligned or mapped array is released
+ * after copying, while an embedded array stays in the vector with its
+ * capacity.
+ *
+ * The returned array is terminated invalid value of specified vector, and
+ * the caller has to release it by the allocator of specified vector
+ * (vector_alloc by default) like the following:
+ *
+ * @code
+ * size_t size;
+ * int *array = vector_detach(v, &size);
+ * ...
+ * vector_alloc(array, UINT_MAX);
+ * @endcode
+ *
+ * @param [in,out] v specified vector
+ * @param [out] size pointer to store the number of components in the returned
+ * array. Alternatively, this can be a null pointer
+ * @return the internal data array of specified vector, or NULL if systems
+ * does not enough memory (specified vector is unchanged in this case)
+ */
+#define vector_detach(v, size) vector_detach_internal(v, size)
+
+/**
+ * Creates a new vector that takes ownership of the specified array without
+ * copying. The array becomes the internal data array of the new vector, so it
+ * MUST be allocated by vector_alloc, and MUST NOT be used by the caller after
+ * this call. The capacity_increment of the new vector is zero.
+ *
+ * The element at the position of size is overwritten with the invalid value,
+ * and the rest of the array beyond it is left as it is.
+ *
+ * This function fails in the following cases:
+ * @li the specified array is NULL
+ * @li the specified capacity is not greater than size
+ * @li does not enough memory
+ *
+ * @param [in] array the array to be owned by the new vector.
+ * The first size elements MUST NOT contain invalid value of the vector
+ * @param [in] size the number of components in the array
+ * @param [in] capacity the number of elements that the array can hold
+ * @return a pointer of new vector if the new vector was created, otherwise NULL
+ * (the caller still owns the array in this case)
+ */
+#define vector_adopt(array, size, capacity) vector_adopt_internal(array, size, capacity)
+
+/**
+ * Appends the vector representation of the type array argument to specified vector.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] array the type array to be appended.
+ * This array MUST be terminated invalid value of specified vector
+ * @return a appended vector that is v
+ */
+#define vector_append(v, array) vector_append_internal(v, array)
+
+/**
+ * Appends n elements of the type array argument to specified vector.
+ * The vector grows at most once.
+ *
+ * @param [in,out] v specified vector
+ * @param [in] array the type array to be appended.
+ * This array MUST NOT contain invalid value of specified vector
+ * @param [in] n the number of elements to be appended
+ * @return a appended vector that is v, or NULL if systems does not enough memory
+ */
+#define vector_append_n(v, array, n) vector_append_n_internal(v, array, n)
+
+/**
+ * Concatenates the v_from vector to the end of v_to vector.
+ *
+ * @param [in,out] v_to specified vector
+ * @param [in] v_from the vector that is concatenated to the end of specified vector
+ * @return a concatenated vector that is v_to, or NULL if systems does not
+ * enough memory
+ */
+#define vector_concat(v_to, v_from) vector_concat_internal(v_to, v_from)
+
+/**
+ * Initialize functions of specified type vector.
+ *
+ * You have to write in your source code like the following:
+ *
+ * @code
+ * #include "vector.h"
+ *
+ * vector_init(int, UINT_MAX);
+ * @endcode
+ *
+ * Or:
+ *
+ * @code
+ * #include "vector.h"
+ *
+ * vector_init(char *, NULL);
+ * @endcode
+ *
+ * @param [in] type type of variable for vector elements
+ * @param [in] invalid invalid value for vector. All vector objects never have
+ * this element
+ * @see #vector_alloc
+ */
+#define vector_init(type, invalid) \
+	typedef struct { \
+		vector_members_internal(type) \
+	} vector; \
+	vector_functions_internal(type, invalid, 0, NULL)
+
+/**
+ * Initialize functions of specified type vector that has n inline slots.
+ * A vector keeps its components in the inline slots until it holds more than
+ * n components, and then moves them to an internal data array allocated by
+ * #vector_alloc. The internal data array is released and the inline slots are
+ * used again when the vector shrinks to n components or less by
+ * #vector_trim_to_size or #VECTOR_AUTO_SHRINK.
+ *
+ * You have to write in your source code like the following:
+ *
+ * @code
+ * #include "vector.h"
+ *
+ * vector_init_small(int, UINT_MAX, 7);
+ * @endcode
+ *
+ * A vector MUST NOT be copied by value while it uses the inline slots, because
+ * it points to its own inline slots.
+ *
+ * @param [in] type type of variable for vector elements
+ * @param [in] invalid invalid value for vector. All vector objects never have
+ * this element
+ * @param [in] n the number of components that the inline slots can hold.
+ * One more slot is added for the invalid value
+ * @see #vector_init
+ */
+#define vector_init_small(type, invalid, n) \
+	typedef struct { \
+		vector_members_internal(type) \
+		type small_elements[(n) + 1]; \
 	} vector; \
+	vector_functions_internal(type, invalid, (n) + 1, v->small_elements)
+
+/*
+ * Settings and state that most vectors never use. A vector allocates its
+ * extension the first time one of them is set, so that the vector itself stays
+ * small. A vector created by #vector_create_with_allocator allocates it by the
+ * allocator when it is created, and every vector releases it by the allocator
+ * that it holds.
+ */
+typedef struct {
+	double growth_factor;
+	size_t min_increment;
+	size_t max_increment;
+	vector_growth_func growth_policy;
+	const vector_allocator *allocator;
+	void *allocator_context;
+	size_t alignment;
+	void *block;
+	size_t *hash_index;
+	size_t hash_mask;
+} vector_extension;
+
+/*
+ * Extension of the vectors that have not allocated their own.
+ */
+static VECTOR_MAYBE_UNUSED const vector_extension vector_default_extension_internal = {
+	0, 0, 0, NULL, NULL, NULL, 0, NULL, NULL, 0
+};
+
+/*
+ * Returns the extension of a vector for reading, which is the default one if
+ * the vector has not allocated its own.
+ */
+#define vector_extension_internal(v) ((v)->extension ? (v)->extension : &vector_default_extension_internal)
+
+#define vector_members_internal(type) \
+	size_t size; \
+	size_t capacity; \
+	size_t capacity_increment; \
+	unsigned int flags; \
+	unsigned int storage; \
+	vector_extension *extension; \
+	type *elements;
+
+#define vector_functions_internal(type, invalid, small_capacity, small_elements) \
+	static VECTOR_MAYBE_UNUSED void vector_inline_init_internal(vector *v, type *elements, size_t capacity) { \
+		v->storage = VECTOR_STORAGE_INLINE; \
+		v->elements = elements; \
+		v->capacity = capacity; \
+		if (v->flags & VECTOR_SENTINEL_ONLY) { \
+			v->elements[0] = invalid; \
+		} else { \
+			size_t i; \
+			for (i = 0; i < capacity; i++) { \
+				v->elements[i] = invalid; \
+			} \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_header_init_internal(vector *v, size_t capacity_increment) { \
+		v->size = 0; \
+		v->capacity = 1; \
+		v->capacity_increment = capacity_increment; \
+		v->flags = VECTOR_DEFAULT_FLAGS; \
+		v->storage = VECTOR_STORAGE_ALLOC; \
+		v->extension = NULL; \
+		v->elements = NULL; \
+		if (small_capacity) { \
+			vector_inline_init_internal(v, (type *) (small_elements), small_capacity); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void *vector_realloc_internal(const vector_allocator *allocator, void *context, void *ptr, size_t size) { \
+		return allocator ? allocator->alloc(context, ptr, size) : vector_alloc(ptr, size); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void *vector_vrealloc_internal(vector *v, void *ptr, size_t size) { \
+		const vector_extension *extension = vector_extension_internal(v); \
+		return vector_realloc_internal(extension->allocator, extension->allocator_context, ptr, size); \
+	} \
 	\
-	static vector *vector_alloc_internal(vector *v, size_t capacity, size_t capacity_increment) { \
-		if (v == NULL) { \
-			v = (vector *) vector_alloc(NULL, sizeof(vector)); \
-			if (v != NULL) { \
-				v->size = 0; \
-				v->capacity = 1; \
-				v->capacity_increment = capacity_increment; \
-				v->elements = NULL; \
-				vector_alloc_internal(v, capacity, capacity_increment); \
+	static VECTOR_MAYBE_UNUSED vector_extension *vector_extend_internal(vector *v) { \
+		if (v->extension == NULL) { \
+			v->extension = (vector_extension *) vector_alloc(NULL, sizeof(vector_extension)); \
+			if (v->extension != NULL) { \
+				*v->extension = vector_default_extension_internal; \
 			} \
-		} else { \
-			v->elements = (type *) vector_alloc(v->elements, capacity * sizeof(type)); \
-			if (v->elements) { \
-				size_t i; \
-				for (i = v->capacity; i < capacity; i++) { \
-					v->elements[i] = invalid; \
-				} \
-				if (v->size == 0) { \
-					v->elements[0] = invalid; \
-				} \
-				if (capacity != 0) { \
-					v->capacity = capacity; \
+		} \
+		return v->extension; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_release_internal(vector *v) { \
+		if (v->storage == VECTOR_STORAGE_ALLOC) { \
+			vector_vrealloc_internal(v, v->elements, UINT_MAX); \
+		} else if (v->storage == VECTOR_STORAGE_ALIGNED) { \
+			vector_vrealloc_internal(v, v->extension->block, UINT_MAX); \
+		} else if (v->storage == VECTOR_STORAGE_MMAP) { \
+			vector_mmap_internal(v->elements, v->capacity * sizeof(type), 0); \
+		} else if (v->storage == VECTOR_STORAGE_HUGE_PAGES) { \
+			vector_huge_mmap_internal(v->elements, v->capacity * sizeof(type), 0); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED unsigned int vector_mmap_wanted_internal(vector *v, size_t capacity) { \
+		size_t alignment = vector_extension_internal(v)->alignment; \
+		if (VECTOR_HAS_MMAP && (v->flags & VECTOR_HUGE_PAGES) && alignment <= VECTOR_HUGE_PAGE_SIZE \
+				&& capacity >= VECTOR_HUGE_PAGES_THRESHOLD / sizeof(type)) { \
+			return VECTOR_STORAGE_HUGE_PAGES; \
+		} \
+		if (VECTOR_HAS_MMAP && (v->flags & VECTOR_MMAP) && alignment <= 4096 \
+				&& capacity >= VECTOR_MMAP_THRESHOLD / sizeof(type)) { \
+			return VECTOR_STORAGE_MMAP; \
+		} \
+		return VECTOR_STORAGE_ALLOC; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_fill_internal(vector *v, size_t capacity) { \
+		if (!(v->flags & VECTOR_SENTINEL_ONLY)) { \
+			size_t i; \
+			for (i = v->capacity; i < capacity; i++) { \
+				v->elements[i] = invalid; \
+			} \
+		} \
+		if (v->size == 0) { \
+			v->elements[0] = invalid; \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED vector *vector_move_internal(vector *v, size_t capacity) { \
+		size_t count = v->flags & VECTOR_SENTINEL_ONLY ? v->size + 1 : v->capacity; \
+		unsigned int storage = vector_mmap_wanted_internal(v, capacity); \
+		size_t alignment = vector_extension_internal(v)->alignment; \
+		char *block = NULL; \
+		type *elements; \
+		if (storage == VECTOR_STORAGE_MMAP) { \
+			block = (char *) vector_mmap_internal(NULL, 0, capacity * sizeof(type)); \
+		} else if (storage == VECTOR_STORAGE_HUGE_PAGES) { \
+			block = (char *) vector_huge_mmap_internal(NULL, 0, capacity * sizeof(type)); \
+		} \
+		if (block == NULL) { \
+			block = (char *) vector_vrealloc_internal(v, NULL, capacity * sizeof(type) + (alignment ? alignment - 1 : 0)); \
+			storage = alignment ? VECTOR_STORAGE_ALIGNED : VECTOR_STORAGE_ALLOC; \
+		} \
+		if (block == NULL) { \
+			return NULL; \
+		} \
+		elements = (type *) (storage == VECTOR_STORAGE_ALIGNED \
+				? block + (alignment - (size_t) block % alignment) % alignment : block); \
+		if (v->elements) { \
+			memcpy(elements, v->elements, (count < capacity ? count : capacity) * sizeof(type)); \
+		} \
+		vector_release_internal(v); \
+		v->storage = storage; \
+		if (storage == VECTOR_STORAGE_ALIGNED) { \
+			v->extension->block = block; \
+		} \
+		v->elements = elements; \
+		vector_fill_internal(v, capacity); \
+		v->capacity = capacity; \
+		return v; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED vector *vector_alloc_internal(vector *v, size_t capacity) { \
+		type *elements; \
+		if (small_capacity && capacity <= small_capacity && v->storage != VECTOR_STORAGE_INLINE \
+				&& v->elements && !vector_extension_internal(v)->alignment) { \
+			size_t count = v->flags & VECTOR_SENTINEL_ONLY ? v->size + 1 \
+					: v->capacity < capacity ? v->capacity : capacity; \
+			elements = v->elements; \
+			v->elements = (type *) (small_elements); \
+			memcpy(v->elements, elements, count * sizeof(type)); \
+			v->elements = elements; \
+			vector_release_internal(v); \
+			v->elements = (type *) (small_elements); \
+			v->storage = VECTOR_STORAGE_INLINE; \
+			v->capacity = count; \
+			vector_fill_internal(v, small_capacity); \
+			v->capacity = small_capacity; \
+			return v; \
+		} \
+		if (v->storage == VECTOR_STORAGE_INLINE && capacity <= v->capacity) { \
+			return v; \
+		} \
+		if (capacity == 0) { \
+			capacity = 1; \
+		} \
+		if (v->storage == VECTOR_STORAGE_MMAP || v->storage == VECTOR_STORAGE_HUGE_PAGES) { \
+			if (vector_mmap_wanted_internal(v, capacity) != v->storage) { \
+				return vector_move_internal(v, capacity); \
+			} \
+			elements = (type *) (v->storage == VECTOR_STORAGE_MMAP \
+					? vector_mmap_internal(v->elements, v->capacity * sizeof(type), capacity * sizeof(type)) \
+					: vector_huge_mmap_internal(v->elements, v->capacity * sizeof(type), capacity * sizeof(type))); \
+			if (elements == NULL) { \
+				return NULL; \
+			} \
+			v->elements = elements; \
+			vector_fill_internal(v, capacity); \
+			v->capacity = capacity; \
+			return v; \
+		} \
+		if (v->storage != VECTOR_STORAGE_ALLOC || vector_extension_internal(v)->alignment \
+				|| vector_mmap_wanted_internal(v, capacity)) { \
+			return vector_move_internal(v, capacity); \
+		} \
+		elements = (type *) vector_vrealloc_internal(v, v->elements, capacity * sizeof(type)); \
+		if (elements == NULL) { \
+			return NULL; \
+		} \
+		v->elements = elements; \
+		vector_fill_internal(v, capacity); \
+		v->capacity = capacity; \
+		return v; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_fini_internal(vector *v) { \
+		vector_release_internal(v); \
+		if (v->extension) { \
+			if (v->extension->hash_index) { \
+				vector_vrealloc_internal(v, v->extension->hash_index, UINT_MAX); \
+			} \
+			vector_vrealloc_internal(v, v->extension, UINT_MAX); \
+			v->extension = NULL; \
+		} \
+		v->storage = VECTOR_STORAGE_ALLOC; \
+		v->elements = NULL; \
+		v->size = 0; \
+		v->capacity = 0; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED vector *vector_create_internal(size_t capacity, size_t capacity_increment, \
+			const vector_allocator *allocator, void *context) { \
+		vector *v = (vector *) vector_realloc_internal(allocator, context, NULL, sizeof(vector)); \
+		if (v != NULL) { \
+			vector_header_init_internal(v, capacity_increment); \
+			if (allocator) { \
+				v->extension = (vector_extension *) vector_realloc_internal(allocator, context, \
+						NULL, sizeof(vector_extension)); \
+				if (v->extension == NULL) { \
+					vector_realloc_internal(allocator, context, v, UINT_MAX); \
+					return NULL; \
 				} \
-			} else { \
+				*v->extension = vector_default_extension_internal; \
+				v->extension->allocator = allocator; \
+				v->extension->allocator_context = context; \
+			} \
+			if (vector_alloc_internal(v, capacity) == NULL) { \
+				vector_fini_internal(v); \
+				vector_realloc_internal(allocator, context, v, UINT_MAX); \
 				v = NULL; \
 			} \
 		} \
 		return v; \
 	} \
 	\
-	static int vector_insert_internal(vector *v, size_t index, type element) { \
-		int result = 0; \
-		if (v->size < v->capacity - 1) { \
-			if (element != invalid) { \
-				size_t i; \
-				for (i = v->size; i > index; i--) { \
-					v->elements[i] = v->elements[i - 1]; \
-				} \
-				v->elements[index] = element; \
-				v->size++; \
-				result = 1; \
+	static VECTOR_MAYBE_UNUSED vector *vector_create_compact_internal(size_t capacity, size_t capacity_increment) { \
+		size_t offset = (sizeof(vector) + sizeof(type) - 1) / sizeof(type) * sizeof(type); \
+		vector *v; \
+		if (capacity == 0) { \
+			capacity = 1; \
+		} \
+		v = (vector *) vector_alloc(NULL, offset + capacity * sizeof(type)); \
+		if (v != NULL) { \
+			vector_header_init_internal(v, capacity_increment); \
+			vector_inline_init_internal(v, (type *) ((char *) v + offset), capacity); \
+		} \
+		return v; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_init_inplace_internal(vector *v, size_t capacity, size_t capacity_increment) { \
+		vector_header_init_internal(v, capacity_increment); \
+		return vector_alloc_internal(v, capacity) != NULL; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_destroy_internal(vector *v) { \
+		if (v) { \
+			const vector_extension *extension = vector_extension_internal(v); \
+			const vector_allocator *allocator = extension->allocator; \
+			void *context = extension->allocator_context; \
+			vector_fini_internal(v); \
+			vector_realloc_internal(allocator, context, v, UINT_MAX); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_grow_capacity_internal(vector *v, size_t min_capacity) { \
+		const vector_extension *extension = vector_extension_internal(v); \
+		size_t new_capacity; \
+		if (extension->growth_policy) { \
+			new_capacity = extension->growth_policy(v->capacity, min_capacity); \
+		} else if (extension->growth_factor > 1.0) { \
+			size_t step = (size_t) (v->capacity * (extension->growth_factor - 1.0)); \
+			if (step < extension->min_increment) { \
+				step = extension->min_increment; \
+			} \
+			if (extension->max_increment && step > extension->max_increment) { \
+				step = extension->max_increment; \
 			} \
+			new_capacity = v->capacity + (step ? step : 1); \
+		} else if (v->capacity_increment) { \
+			new_capacity = v->capacity + v->capacity_increment; \
 		} else { \
-			size_t new_capacity; \
-			if (v->capacity_increment) { \
-				new_capacity = v->capacity + v->capacity_increment; \
-			} else { \
-				new_capacity = v->capacity * 2; \
+			new_capacity = v->capacity * 2; \
+		} \
+		return new_capacity < min_capacity ? min_capacity : new_capacity; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_set_growth_factor_internal(vector *v, double factor, size_t min_step, \
+			size_t max_step) { \
+		vector_extension *extension = vector_extend_internal(v); \
+		if (extension == NULL) { \
+			return 0; \
+		} \
+		extension->growth_factor = factor; \
+		extension->min_increment = min_step; \
+		extension->max_increment = max_step; \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_set_growth_policy_internal(vector *v, vector_growth_func policy) { \
+		vector_extension *extension = vector_extend_internal(v); \
+		if (extension == NULL) { \
+			return 0; \
+		} \
+		extension->growth_policy = policy; \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_ensure_capacity_internal(vector *v, size_t min_capacity) { \
+		if (v->capacity >= min_capacity) { \
+			return 1; \
+		} \
+		return vector_alloc_internal(v, min_capacity) != NULL; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_trim_to_size_internal(vector *v) { \
+		if (v->capacity > v->size + 1) { \
+			vector_alloc_internal(v, v->size + 1); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_shrink_internal(vector *v) { \
+		if ((v->flags & VECTOR_AUTO_SHRINK) && v->size + 1 < v->capacity / 4) { \
+			vector_alloc_internal(v, (v->size + 1) * 2); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_set_alignment_internal(vector *v, size_t alignment) { \
+		vector_extension *extension; \
+		size_t old_alignment = vector_extension_internal(v)->alignment; \
+		if (alignment & (alignment - 1)) { \
+			return 0; \
+		} \
+		if (alignment == old_alignment) { \
+			return 1; \
+		} \
+		extension = vector_extend_internal(v); \
+		if (extension == NULL) { \
+			return 0; \
+		} \
+		extension->alignment = alignment; \
+		if (alignment && ((size_t) v->elements % alignment \
+				|| (v->storage == VECTOR_STORAGE_MMAP && alignment > 4096) \
+				|| (v->storage == VECTOR_STORAGE_HUGE_PAGES && alignment > VECTOR_HUGE_PAGE_SIZE)) \
+				&& vector_move_internal(v, v->capacity) == NULL) { \
+			extension->alignment = old_alignment; \
+			return 0; \
+		} \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_alignment_internal(vector *v) { \
+		size_t address = (size_t) v->elements; \
+		return address & (~address + 1); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_huge_pages_internal(vector *v) { \
+		size_t mask = VECTOR_HUGE_PAGE_SIZE - 1; \
+		size_t size; \
+		if (v->storage != VECTOR_STORAGE_HUGE_PAGES) { \
+			return 0; \
+		} \
+		size = vector_huge_pages_size_internal(v->elements); \
+		return size < ((v->capacity * sizeof(type) + mask) & ~mask) \
+				? size : (v->capacity * sizeof(type) + mask) & ~mask; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_hash_internal(type element) { \
+		const unsigned char *p = (const unsigned char *) &element; \
+		size_t hash = 2166136261U, i; \
+		if (element == 0) { \
+			element = 0; /* -0.0 equals 0.0 */ \
+		} \
+		for (i = 0; i < sizeof(type); i++) { \
+			hash = (hash ^ p[i]) * 16777619U; \
+		} \
+		return hash ^ (hash >> 16); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_put_internal(vector *v, size_t position) { \
+		vector_extension *extension = v->extension; \
+		size_t i = vector_hash_internal(v->elements[position]) & extension->hash_mask; \
+		while (extension->hash_index[i]) { \
+			i = (i + 1) & extension->hash_mask; \
+		} \
+		extension->hash_index[i] = position + 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_index_slot_internal(vector *v, size_t position) { \
+		vector_extension *extension = v->extension; \
+		size_t i = vector_hash_internal(v->elements[position]) & extension->hash_mask; \
+		while (extension->hash_index[i] != position + 1) { \
+			i = (i + 1) & extension->hash_mask; \
+		} \
+		return i; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_delete_internal(vector *v, size_t position) { \
+		size_t *index = v->extension->hash_index, mask = v->extension->hash_mask; \
+		size_t i = vector_index_slot_internal(v, position), j = i, home; \
+		for (;;) { \
+			j = (j + 1) & mask; \
+			if (!index[j]) { \
+				break; \
+			} \
+			home = vector_hash_internal(v->elements[index[j] - 1]) & mask; \
+			if (i <= j ? i < home && home <= j : i < home || home <= j) { \
+				continue; \
+			} \
+			index[i] = index[j]; \
+			i = j; \
+		} \
+		index[i] = 0; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_shift_internal(vector *v, size_t from, size_t to, int up) { \
+		size_t *index = v->extension->hash_index; \
+		size_t p; \
+		if (up) { \
+			for (p = to; p > from; p--) { \
+				index[vector_index_slot_internal(v, p - 1)] = p + 1; \
+			} \
+		} else { \
+			for (p = from; p < to; p++) { \
+				index[vector_index_slot_internal(v, p)] = p; \
+			} \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_disable_hash_index_internal(vector *v) { \
+		if (v->extension && v->extension->hash_index) { \
+			vector_vrealloc_internal(v, v->extension->hash_index, UINT_MAX); \
+			v->extension->hash_index = NULL; \
+			v->extension->hash_mask = 0; \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_index_rebuild_internal(vector *v, size_t n) { \
+		vector_extension *extension = vector_extend_internal(v); \
+		size_t slots, i; \
+		if (extension == NULL) { \
+			return 0; \
+		} \
+		slots = extension->hash_index ? extension->hash_mask + 1 : 16; \
+		while (slots < n * 2) { \
+			slots *= 2; \
+		} \
+		if (slots - 1 != extension->hash_mask) { \
+			size_t *index = (size_t *) vector_vrealloc_internal(v, NULL, slots * sizeof(size_t)); \
+			if (index == NULL) { \
+				vector_disable_hash_index_internal(v); \
+				return 0; \
+			} \
+			if (extension->hash_index) { \
+				vector_vrealloc_internal(v, extension->hash_index, UINT_MAX); \
+			} \
+			extension->hash_index = index; \
+			extension->hash_mask = slots - 1; \
+		} \
+		memset(extension->hash_index, 0, slots * sizeof(size_t)); \
+		for (i = 0; i < v->size; i++) { \
+			vector_index_put_internal(v, i); \
+		} \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_index_reserve_internal(vector *v, size_t n) { \
+		if (!vector_has_hash_index(v) || n * 2 <= v->extension->hash_mask + 1) { \
+			return 1; \
+		} \
+		return vector_index_rebuild_internal(v, n * 2); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_refresh_internal(vector *v) { \
+		if (vector_has_hash_index(v)) { \
+			vector_index_rebuild_internal(v, v->size + 1); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_clear_internal(vector *v) { \
+		if (vector_has_hash_index(v)) { \
+			memset(v->extension->hash_index, 0, (v->extension->hash_mask + 1) * sizeof(size_t)); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_index_append_internal(vector *v, size_t from) { \
+		if (vector_has_hash_index(v)) { \
+			for (; from < v->size; from++) { \
+				vector_index_put_internal(v, from); \
 			} \
-			if (vector_alloc_internal(v, new_capacity, v->capacity_increment)) { \
-				result = vector_insert_internal(v, index, element); \
+		} \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_enable_hash_index_internal(vector *v) { \
+		if (vector_has_hash_index(v)) { \
+			return 1; \
+		} \
+		return vector_index_rebuild_internal(v, v->size + 1); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_index_search_internal(vector *v, type element, size_t start, size_t end, \
+			int last) { \
+		const size_t *index = v->extension->hash_index; \
+		size_t mask = v->extension->hash_mask; \
+		size_t i = vector_hash_internal(element) & mask, result = VECTOR_NPOS; \
+		for (; index[i]; i = (i + 1) & mask) { \
+			size_t position = index[i] - 1; \
+			if (position >= start && position < end && v->elements[position] == element \
+					&& (result == VECTOR_NPOS || (last ? position > result : position < result))) { \
+				result = position; \
 			} \
 		} \
 		return result; \
 	} \
 	\
-	static type vector_remove_internal(vector *v, size_t index) { \
+	static VECTOR_MAYBE_UNUSED int vector_insert_internal(vector *v, size_t index, type element) { \
+		int indexed; \
+		if (v->size >= v->capacity - 1 \
+				&& !vector_alloc_internal(v, vector_grow_capacity_internal(v, v->capacity + 1))) { \
+			return 0; \
+		} \
+		if (element == invalid || index > v->size) { \
+			return 0; \
+		} \
+		if ((v->flags & VECTOR_SORTED) && ((index > 0 && element < v->elements[index - 1]) \
+				|| (index < v->size && v->elements[index] < element))) { \
+			v->flags &= ~VECTOR_SORTED; \
+		} \
+		indexed = vector_has_hash_index(v) && vector_index_reserve_internal(v, v->size + 1); \
+		if (indexed) { \
+			vector_index_shift_internal(v, index, v->size, 1); \
+		} \
+		if (index < v->size) { \
+			memmove(v->elements + index + 1, v->elements + index, (v->size - index) * sizeof(type)); \
+		} \
+		v->elements[index] = element; \
+		v->size++; \
+		v->elements[v->size] = invalid; \
+		if (indexed) { \
+			vector_index_put_internal(v, index); \
+		} \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED type vector_set_internal(vector *v, size_t index, type element) { \
+		type old_element = v->elements[index]; \
+		v->flags &= ~VECTOR_SORTED; \
+		if (vector_has_hash_index(v)) { \
+			vector_index_delete_internal(v, index); \
+		} \
+		v->elements[index] = element; \
+		if (vector_has_hash_index(v)) { \
+			vector_index_put_internal(v, index); \
+		} \
+		return old_element; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_insert_array_internal(vector *v, size_t index, const type *array, size_t n) { \
+		size_t min_capacity = v->size + n + 1; \
+		if (index > v->size) { \
+			return 0; \
+		} \
+		if (v->capacity < min_capacity && \
+				!vector_ensure_capacity_internal(v, vector_grow_capacity_internal(v, min_capacity))) { \
+			return 0; \
+		} \
+		if (n > 0) { \
+			v->flags &= ~VECTOR_SORTED; \
+		} \
+		vector_index_reserve_internal(v, v->size + n); \
+		memmove(v->elements + index + n, v->elements + index, (v->size - index) * sizeof(type)); \
+		memcpy(v->elements + index, array, n * sizeof(type)); \
+		v->size += n; \
+		v->elements[v->size] = invalid; \
+		if (index + n == v->size) { \
+			vector_index_append_internal(v, index); \
+		} else { \
+			vector_index_refresh_internal(v); \
+		} \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED type *vector_reserve_back_internal(vector *v, size_t n) { \
+		size_t min_capacity = v->size + n + 1; \
+		if (v->capacity < min_capacity && \
+				!vector_ensure_capacity_internal(v, vector_grow_capacity_internal(v, min_capacity))) { \
+			return NULL; \
+		} \
+		return v->elements + v->size; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_commit_internal(vector *v, size_t n) { \
+		if (n > v->capacity - v->size - 1) { \
+			return 0; \
+		} \
+		if (n > 0) { \
+			v->flags &= ~VECTOR_SORTED; \
+		} \
+		vector_index_reserve_internal(v, v->size + n); \
+		v->size += n; \
+		v->elements[v->size] = invalid; \
+		vector_index_append_internal(v, v->size - n); \
+		return 1; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED type vector_remove_internal(vector *v, size_t index) { \
 		type element = v->elements[index]; \
-		size_t i; \
-		for (i = index + 1; i < v->size; i++) { \
-			v->elements[i - 1] = v->elements[i]; \
+		if (vector_has_hash_index(v)) { \
+			vector_index_delete_internal(v, index); \
+			vector_index_shift_internal(v, index + 1, v->size, 0); \
 		} \
+		memmove(v->elements + index, v->elements + index + 1, (v->size - index - 1) * sizeof(type)); \
 		v->size--; \
 		v->elements[v->size] = invalid; \
+		vector_shrink_internal(v); \
 		return element; \
 	} \
 	\
-	static int vector_index_of_internal(vector *v, type element) { \
-		size_t i, n = v->size < INT_MAX ? v->size : INT_MAX; \
-		for (i = 0; i < n; i++) { \
-			if (v->elements[i] == element) { \
-				return i; \
+	static VECTOR_MAYBE_UNUSED type vector_swap_remove_internal(vector *v, size_t index) { \
+		type element = v->elements[index]; \
+		if (vector_has_hash_index(v)) { \
+			vector_index_delete_internal(v, index); \
+			if (index < v->size - 1) { \
+				v->extension->hash_index[vector_index_slot_internal(v, v->size - 1)] = index + 1; \
+			} \
+		} \
+		v->size--; \
+		if (index < v->size) { \
+			v->flags &= ~VECTOR_SORTED; \
+		} \
+		v->elements[index] = v->elements[v->size]; \
+		v->elements[v->size] = invalid; \
+		vector_shrink_internal(v); \
+		return element; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_remove_range_internal(vector *v, size_t from, size_t to) { \
+		size_t i; \
+		if (from > to || to > v->size) { \
+			return 0; \
+		} \
+		if (vector_has_hash_index(v) && to == v->size) { \
+			for (i = from; i < to; i++) { \
+				vector_index_delete_internal(v, i); \
 			} \
 		} \
-		return -1; \
+		memmove(v->elements + from, v->elements + to, (v->size - to) * sizeof(type)); \
+		v->size -= to - from; \
+		v->elements[v->size] = invalid; \
+		if (from < to && from < v->size) { \
+			vector_index_refresh_internal(v); \
+		} \
+		vector_shrink_internal(v); \
+		return 1; \
 	} \
 	\
-	static void vector_clear(vector *v) { \
-		while (v->size) { \
-			v->elements[--(v->size)] = invalid; \
+	static VECTOR_MAYBE_UNUSED int vector_compare_internal(const void *a, const void *b) { \
+		return *(const type *) a < *(const type *) b ? -1 : *(const type *) b < *(const type *) a; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_sort_internal(vector *v) { \
+		qsort(v->elements, v->size, sizeof(type), vector_compare_internal); \
+		v->flags |= VECTOR_SORTED; \
+		vector_index_refresh_internal(v); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_bound_internal(vector *v, type element, size_t start, size_t end, \
+			int upper) { \
+		while (start < end) { \
+			size_t middle = start + (end - start) / 2; \
+			if (upper ? !(element < v->elements[middle]) : v->elements[middle] < element) { \
+				start = middle + 1; \
+			} else { \
+				end = middle; \
+			} \
 		} \
+		return start; \
 	} \
 	\
-	static const type *vector_to_array_internal(vector *v) { \
-		return (const type *) v->elements; \
+	static VECTOR_MAYBE_UNUSED size_t vector_bsearch_internal(vector *v, type element, size_t start, \
+			size_t end, int last) { \
+		size_t i = vector_bound_internal(v, element, start, end, last); \
+		if (last) { \
+			return i > start && v->elements[i - 1] == element ? i - 1 : VECTOR_NPOS; \
+		} \
+		return i < end && v->elements[i] == element ? i : VECTOR_NPOS; \
 	} \
 	\
-	static const vector *vector_append_internal(vector *v, type *array) { \
+	static VECTOR_MAYBE_UNUSED size_t vector_lower_bound_internal(vector *v, type element) { \
+		return vector_bound_internal(v, element, 0, v->size, 0); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_binary_search_internal(vector *v, type element) { \
+		return vector_bsearch_internal(v, element, 0, v->size, 0); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_insert_sorted_internal(vector *v, type element) { \
+		return vector_insert_internal(v, vector_bound_internal(v, element, 0, v->size, 1), element); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_search_internal(vector *v, type element, size_t start, size_t end, \
+			int last) { \
+		vector_find_func find = vector_find_func_internal(vector_find_kind_internal(type), last); \
 		size_t i; \
-		for (i = 0; array[i] != invalid; i++) { \
-			vector_add(v, array[i]); \
+		if (start >= end) { \
+			return VECTOR_NPOS; \
+		} \
+		if (vector_has_hash_index(v)) { \
+			return vector_index_search_internal(v, element, start, end, last); \
+		} \
+		if (v->flags & VECTOR_SORTED) { \
+			return vector_bsearch_internal(v, element, start, end, last); \
+		} \
+		if (find) { \
+			i = find(v->elements + start, end - start, &element); \
+			return i == VECTOR_NPOS ? VECTOR_NPOS : start + i; \
+		} \
+		if (last) { \
+			for (i = end; i > start; i--) { \
+				if (v->elements[i - 1] == element) { \
+					return i - 1; \
+				} \
+			} \
+		} else { \
+			for (i = start; i < end; i++) { \
+				if (v->elements[i] == element) { \
+					return i; \
+				} \
+			} \
+		} \
+		return VECTOR_NPOS; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_find_from_internal(vector *v, type element, size_t start) { \
+		return vector_search_internal(v, element, start, v->size, 0); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED size_t vector_rfind_internal(vector *v, type element) { \
+		return vector_search_internal(v, element, 0, v->size, 1); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_index_of_from_internal(vector *v, type element, size_t start) { \
+		size_t i = vector_search_internal(v, element, start, v->size < INT_MAX ? v->size : INT_MAX, 0); \
+		return i == VECTOR_NPOS ? -1 : (int) i; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_index_of_internal(vector *v, type element) { \
+		return vector_index_of_from_internal(v, element, 0); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED int vector_last_index_of_internal(vector *v, type element) { \
+		size_t i = vector_search_internal(v, element, 0, v->size < INT_MAX ? v->size : INT_MAX, 1); \
+		return i == VECTOR_NPOS ? -1 : (int) i; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED void vector_clear_internal(vector *v) { \
+		v->size = 0; \
+		v->elements[0] = invalid; \
+		vector_index_clear_internal(v); \
+		vector_shrink_internal(v); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED const type *vector_to_array_internal(vector *v) { \
+		return (const type *) v->elements; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED type *vector_detach_internal(vector *v, size_t *size) { \
+		type *elements = v->elements; \
+		size_t old_size = v->size, old_capacity = v->capacity; \
+		if (v->storage != VECTOR_STORAGE_ALLOC) { \
+			elements = (type *) vector_vrealloc_internal(v, NULL, (v->size + 1) * sizeof(type)); \
+			if (elements == NULL) { \
+				return NULL; \
+			} \
+			memcpy(elements, v->elements, (v->size + 1) * sizeof(type)); \
+			v->size = 0; \
+			v->elements[0] = invalid; \
+			vector_index_clear_internal(v); \
+			if (v->storage != VECTOR_STORAGE_INLINE) { \
+				vector_alloc_internal(v, 1); \
+			} \
+			if (size) { \
+				*size = old_size; \
+			} \
+			return elements; \
+		} \
+		v->elements = NULL; \
+		v->size = 0; \
+		v->capacity = 1; \
+		if (small_capacity) { \
+			vector_inline_init_internal(v, (type *) (small_elements), small_capacity); \
+		} else if (vector_alloc_internal(v, 1) == NULL) { \
+			v->elements = elements; \
+			v->size = old_size; \
+			v->capacity = old_capacity; \
+			return NULL; \
+		} \
+		vector_index_clear_internal(v); \
+		if (size) { \
+			*size = old_size; \
+		} \
+		return elements; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED vector *vector_adopt_internal(type *array, size_t size, size_t capacity) { \
+		vector *v; \
+		if (array == NULL || capacity <= size) { \
+			return NULL; \
+		} \
+		v = (vector *) vector_alloc(NULL, sizeof(vector)); \
+		if (v != NULL) { \
+			vector_header_init_internal(v, 0); \
+			v->storage = VECTOR_STORAGE_ALLOC; \
+			v->size = size; \
+			v->capacity = capacity; \
+			v->elements = array; \
+			v->elements[size] = invalid; \
 		} \
 		return v; \
 	} \
 	\
-	static const vector *vector_concat_internal(vector *v_to, vector *v_from) { \
-		return vector_append(v_to, v_from->elements); \
+	static VECTOR_MAYBE_UNUSED const vector *vector_append_n_internal(vector *v, const type *array, size_t n) { \
+		return vector_insert_array_internal(v, v->size, array, n) ? v : NULL; \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED const vector *vector_append_internal(vector *v, type *array) { \
+		size_t n; \
+		for (n = 0; array[n] != invalid; n++) { \
+		} \
+		return vector_append_n_internal(v, array, n); \
+	} \
+	\
+	static VECTOR_MAYBE_UNUSED const vector *vector_concat_internal(vector *v_to, vector *v_from) { \
+		if (!vector_reserve(v_to, v_from->size)) { \
+			return NULL; \
+		} \
+		return vector_append_n_internal(v_to, v_from->elements, v_from->size); \
 	}
 
 #endif
@@ -0,0 +1,185 @@
+#ifndef VECTOR_ARENA_H_
+#define VECTOR_ARENA_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "vector.h"
+
+/**
+ * @file
+ * The arena functions implement a bump allocator for the vector functions.
+ * Memory blocks are carved from one buffer in order, and all of them are
+ * released at once by #vector_arena_reset. The last allocated block can grow
+ * and shrink in place, so a vector that is built up while no other block is
+ * allocated is never copied.
+ *
+ * You can use an arena as the memory allocator of the vector functions like
+ * the following:
+ *
+ * @code
+ * #include "vector.h"
+ * #include "vector_arena.h"
+ *
+ * vector_init(int, INT_MAX);
+ *
+ * static vector_arena arena;
+ *
+ * static void *vector_alloc(void *ptr, size_t size) {
+ *     return vector_arena_alloc(&arena, ptr, size);
+ * }
+ * @endcode
+ *
+ * Or you can give an arena to each vector by #vector_arena_allocator:
+ *
+ * @code
+ * vector *v = vector_create_with_allocator(0, 0, &vector_arena_allocator, &arena);
+ * @endcode
+ *
+ * The arena never calls malloc after #vector_arena_init, so allocation fails
+ * when the buffer of the arena is exhausted.
+ */
+
+/**
+ * Header of a memory block in an arena.
+ * This union also gives the alignment of memory blocks.
+ */
+typedef union {
+	size_t size;
+	void *align_pointer;
+	double align_double;
+	long double align_long_double;
+	long align_long;
+} vector_arena_block;
+
+/**
+ * Bump allocator for the vector functions.
+ */
+typedef struct {
+	char *buffer;
+	size_t size;
+	size_t used;
+	size_t last;
+	int owns_buffer;
+} vector_arena;
+
+/**
+ * Initialize specified arena.
+ *
+ * @param [out] arena specified arena
+ * @param [in] buffer the memory used by the arena, which MUST be aligned for
+ * any type. Alternatively, this can be a null pointer, in which case a buffer
+ * is allocated by malloc and it is released by #vector_arena_destroy
+ * @param [in] size size of the buffer, in bytes
+ * @return true if the arena was initialized, otherwise false
+ */
+static VECTOR_MAYBE_UNUSED int vector_arena_init(vector_arena *arena, void *buffer, size_t size) {
+	arena->owns_buffer = buffer == NULL;
+	if (buffer == NULL) {
+		buffer = malloc(size);
+		if (buffer == NULL) {
+			return 0;
+		}
+	}
+	arena->buffer = (char *) buffer;
+	arena->size = size;
+	arena->used = 0;
+	arena->last = (size_t) -1;
+	return 1;
+}
+
+/**
+ * Destroy specified arena.
+ * All memory blocks allocated from the arena are released.
+ *
+ * @param [in,out] arena specified arena
+ */
+static VECTOR_MAYBE_UNUSED void vector_arena_destroy(vector_arena *arena) {
+	if (arena->owns_buffer) {
+		free(arena->buffer);
+	}
+	arena->buffer = NULL;
+	arena->size = 0;
+	arena->used = 0;
+	arena->last = (size_t) -1;
+}
+
+/**
+ * Releases all memory blocks allocated from specified arena in constant time.
+ * Vectors that use the arena MUST NOT be used after this call.
+ *
+ * @param [in,out] arena specified arena
+ */
+static VECTOR_MAYBE_UNUSED void vector_arena_reset(vector_arena *arena) {
+	arena->used = 0;
+	arena->last = (size_t) -1;
+}
+
+/**
+ * Memory allocator that has the same interface as #vector_alloc.
+ * Releasing a memory block gives its memory back to the arena only if it is
+ * the last allocated block.
+ *
+ * @param [in,out] arena specified arena
+ * @param [in] ptr pointer to a memory block previously allocated from the
+ * arena. Alternatively, this can be a null pointer, in which case a new block
+ * is allocated
+ * @param [in] size new size for the memory block, in bytes.
+ * Alternatively, this function releases memory block if size is UINT_MAX
+ * @return a pointer to the reallocated memory block, which may be either the
+ * same as ptr or a new location. Or a null pointer if the arena does not have
+ * enough memory or size specified UINT_MAX
+ */
+static VECTOR_MAYBE_UNUSED void *vector_arena_alloc(vector_arena *arena, void *ptr, size_t size) {
+	vector_arena_block *block = ptr ? (vector_arena_block *) ptr - 1 : NULL;
+	size_t offset = block ? (size_t) ((char *) block - arena->buffer) : (size_t) -1;
+	size_t needed;
+	void *result;
+	if (size == UINT_MAX) {
+		if (block && offset == arena->last) {
+			arena->used = offset;
+			arena->last = (size_t) -1;
+		}
+		return NULL;
+	}
+	if (size > arena->size) {
+		return NULL;
+	}
+	needed = sizeof(vector_arena_block)
+			+ (size + sizeof(vector_arena_block) - 1) / sizeof(vector_arena_block) * sizeof(vector_arena_block);
+	if (block && offset == arena->last) {
+		if (needed > arena->size - offset) {
+			return NULL;
+		}
+		arena->used = offset + needed;
+		block->size = size;
+		return ptr;
+	}
+	if (needed > arena->size - arena->used) {
+		return NULL;
+	}
+	result = (vector_arena_block *) (arena->buffer + arena->used) + 1;
+	((vector_arena_block *) result - 1)->size = size;
+	if (block) {
+		memcpy(result, ptr, block->size < size ? block->size : size);
+	}
+	arena->last = arena->used;
+	arena->used += needed;
+	return result;
+}
+
+static VECTOR_MAYBE_UNUSED void *vector_arena_allocator_alloc(void *context, void *ptr, size_t size) {
+	return vector_arena_alloc((vector_arena *) context, ptr, size);
+}
+
+/**
+ * Allocator of a vector that allocates memory from the arena specified as the
+ * context.
+ *
+ * @see #vector_create_with_allocator
+ */
+static VECTOR_MAYBE_UNUSED const vector_allocator vector_arena_allocator = { vector_arena_allocator_alloc };
+
+#endif
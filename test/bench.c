@@ -0,0 +1,275 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include <time.h>
+
+#include "vector.h"
+
+vector_init(int, INT_MAX);
+
+static void *vector_alloc(void *ptr, size_t size) {
+	if (size == UINT_MAX) {
+		free(ptr);
+		return NULL;
+	}
+	return realloc(ptr, size);
+}
+
+#define BENCH_SIZE 100000
+#define BENCH_LOOPS 2000
+
+static double elapsed(clock_t start) {
+	return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+static vector *bench_vector(void) {
+	vector *v = vector_create(BENCH_SIZE + 2, 0);
+	int i;
+	for (i = 0; i < BENCH_SIZE; i++) {
+		vector_add(v, i);
+	}
+	return v;
+}
+
+/*
+ * Keeps the compiler from turning the scalar loops into memmove or vector
+ * instructions, so that they stay the loops vector.h used to have.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define BENCH_SCALAR __attribute__((optimize("no-tree-vectorize", "no-tree-loop-distribute-patterns")))
+#else
+#define BENCH_SCALAR
+#endif
+
+/* shifts the tail one element at a time, as vector_insert did before */
+static BENCH_SCALAR void scalar_insert(vector *v, size_t index, int element) {
+	size_t i;
+	for (i = v->size; i > index; i--) {
+		v->elements[i] = v->elements[i - 1];
+	}
+	v->elements[index] = element;
+	v->size++;
+	v->elements[v->size] = INT_MAX;
+}
+
+/* shifts the tail one element at a time, as vector_remove did before */
+static BENCH_SCALAR int scalar_remove(vector *v, size_t index) {
+	int element = v->elements[index];
+	size_t i;
+	for (i = index + 1; i < v->size; i++) {
+		v->elements[i - 1] = v->elements[i];
+	}
+	v->size--;
+	v->elements[v->size] = INT_MAX;
+	return element;
+}
+
+static void bench_insert_remove(void) {
+	vector *v = bench_vector();
+	clock_t start;
+	long check = 0;
+	int i;
+	start = clock();
+	for (i = 0; i < BENCH_LOOPS; i++) {
+		scalar_insert(v, 0, i);
+		check += scalar_remove(v, 0);
+	}
+	printf("insert/remove at head, scalar loop: %8.3f sec\n", elapsed(start));
+	start = clock();
+	for (i = 0; i < BENCH_LOOPS; i++) {
+		vector_insert(v, 0, i);
+		check -= vector_remove(v, 0);
+	}
+	printf("insert/remove at head, vector.h:    %8.3f sec\n", elapsed(start));
+	if (check != 0 || vector_get(v, BENCH_SIZE - 1) != BENCH_SIZE - 1) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+static void bench_append(void) {
+	vector *v = vector_create(BENCH_SIZE + 2, 0);
+	clock_t start;
+	long check = 0;
+	int i, j;
+	start = clock();
+	for (i = 0; i < BENCH_LOOPS; i++) {
+		vector_clear(v);
+		for (j = 0; j < BENCH_SIZE; j++) {
+			scalar_insert(v, v->size, j);
+		}
+		check += v->elements[BENCH_SIZE - 1];
+	}
+	printf("append, scalar loop: %8.3f sec\n", elapsed(start));
+	start = clock();
+	for (i = 0; i < BENCH_LOOPS; i++) {
+		vector_clear(v);
+		for (j = 0; j < BENCH_SIZE; j++) {
+			vector_add(v, j);
+		}
+		check -= vector_get(v, BENCH_SIZE - 1);
+	}
+	printf("append, vector.h:    %8.3f sec\n", elapsed(start));
+	if (check != 0) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+/* compares one element at a time, as vector_index_of did before */
+static int scalar_index_of(vector *v, int element) {
+	size_t i;
+	for (i = 0; i < v->size; i++) {
+		if (v->elements[i] == element) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void bench_index_of(int size, int loops) {
+	vector *v = vector_create(size + 1, 0);
+	clock_t start;
+	long check = 0;
+	int i;
+	for (i = 0; i < size; i++) {
+		vector_add(v, i);
+	}
+	start = clock();
+	for (i = 0; i < loops; i++) {
+		check += scalar_index_of(v, i % size);
+	}
+	printf("index_of in %6d ints, scalar loop: %8.3f sec\n", size, elapsed(start));
+	start = clock();
+	for (i = 0; i < loops; i++) {
+		check -= vector_index_of(v, i % size);
+	}
+	printf("index_of in %6d ints, vector.h:    %8.3f sec\n", size, elapsed(start));
+	if (check != 0) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+#define BENCH_SORTED_SIZE 1000000
+#define BENCH_SORTED_LOOPS 10000
+
+static void bench_sorted(void) {
+	vector *v = vector_create(BENCH_SORTED_SIZE + 1, 0);
+	clock_t start;
+	long check = 0;
+	int i;
+	for (i = 0; i < BENCH_SORTED_SIZE; i++) {
+		vector_add(v, (int) ((i * 7919L) % BENCH_SORTED_SIZE));
+	}
+	start = clock();
+	for (i = 0; i < BENCH_SORTED_LOOPS; i++) {
+		check += vector_contains(v, i * 97);
+	}
+	printf("contains in %d ints, unsorted:     %8.3f sec\n", BENCH_SORTED_SIZE, elapsed(start));
+	vector_sort(v);
+	start = clock();
+	for (i = 0; i < BENCH_SORTED_LOOPS; i++) {
+		check -= vector_contains(v, i * 97);
+	}
+	printf("contains in %d ints, VECTOR_SORTED: %7.3f sec\n", BENCH_SORTED_SIZE, elapsed(start));
+	if (check != 0) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+#define BENCH_SET_SIZE 50000
+
+static void bench_set(const char *name, int indexed) {
+	vector *v = vector_create(0, 0);
+	clock_t start;
+	int i;
+	if (indexed) {
+		vector_enable_hash_index(v);
+	}
+	start = clock();
+	for (i = 0; i < BENCH_SET_SIZE * 2; i++) {
+		int element = (int) ((i * 7919L) % BENCH_SET_SIZE);
+		if (!vector_contains(v, element)) {
+			vector_add(v, element);
+		}
+	}
+	printf("build set of %d ints, %-12s %8.3f sec\n", BENCH_SET_SIZE, name, elapsed(start));
+	if (vector_size(v) != BENCH_SET_SIZE) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+#define BENCH_GROWTH_SIZE (64 * 1024 * 1024)
+
+static void bench_growth(const char *name, unsigned int flags, size_t alignment) {
+	vector *v = vector_create(1, 0);
+	clock_t start;
+	int *slots;
+	int i;
+	vector_set_flags(v, flags | VECTOR_SENTINEL_ONLY);
+	vector_set_alignment(v, alignment);
+	slots = vector_reserve_back(v, BENCH_GROWTH_SIZE);
+	for (i = 0; i < BENCH_GROWTH_SIZE; i++) {
+		slots[i] = i;
+	}
+	vector_commit(v, BENCH_GROWTH_SIZE);
+	start = clock();
+	vector_reserve(v, BENCH_GROWTH_SIZE);
+	printf("grow %d MB to %d MB, %-16s %8.3f sec\n", BENCH_GROWTH_SIZE / (1024 * 1024) * (int) sizeof(int),
+			BENCH_GROWTH_SIZE / (1024 * 1024) * (int) sizeof(int) * 2, name, elapsed(start));
+	if (vector_get(v, BENCH_GROWTH_SIZE - 1) != BENCH_GROWTH_SIZE - 1) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+#define BENCH_GET_SIZE (64 * 1024 * 1024)
+#define BENCH_GET_LOOPS (32 * 1024 * 1024)
+
+static void bench_get(const char *name, unsigned int flags) {
+	vector *v = vector_create(1, 0);
+	clock_t start;
+	unsigned long x = 1;
+	long check = 0;
+	int *slots;
+	int i;
+	vector_set_flags(v, flags | VECTOR_SENTINEL_ONLY);
+	slots = vector_reserve_back(v, BENCH_GET_SIZE);
+	for (i = 0; i < BENCH_GET_SIZE; i++) {
+		slots[i] = i;
+	}
+	vector_commit(v, BENCH_GET_SIZE);
+	start = clock();
+	for (i = 0; i < BENCH_GET_LOOPS; i++) {
+		x = x * 1103515245 + 12345;
+		check += vector_get(v, (x >> 8) % BENCH_GET_SIZE);
+	}
+	printf("random get in %d MB, %-18s %8.3f sec (%lu MB in huge pages)\n",
+			BENCH_GET_SIZE / (1024 * 1024) * (int) sizeof(int), name, elapsed(start),
+			(unsigned long) (vector_huge_pages(v) / (1024 * 1024)));
+	if (check < 0) {
+		printf("unexpected result\n");
+	}
+	vector_destroy(v);
+}
+
+int main(int argc, char *argv[]) {
+	printf("vector size: %d, loops: %d\n", BENCH_SIZE, BENCH_LOOPS);
+	bench_insert_remove();
+	bench_append();
+	bench_index_of(1000, 1000000);
+	bench_index_of(100000, 10000);
+	bench_sorted();
+	bench_set("linear:", 0);
+	bench_set("hash index:", 1);
+	bench_growth("aligned copy:", 0, 64);
+	bench_growth("vector_alloc:", 0, 0);
+	bench_growth("VECTOR_MMAP:", VECTOR_MMAP, 0);
+	bench_get("VECTOR_MMAP:", VECTOR_MMAP);
+	bench_get("VECTOR_HUGE_PAGES:", VECTOR_HUGE_PAGES);
+	return EXIT_SUCCESS;
+}
@@ -1,20 +1,27 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <limits.h>
 
 #include <CUnit.h>
 #include <Console.h>
 
+#define VECTOR_MMAP_THRESHOLD (64 * 1024)
+
 #include "vector.h"
+#include "vector_arena.h"
 
 vector_init(int, INT_MAX);
 
+static int alloc_count;
+
 static void *vector_alloc(void *ptr, size_t size) {
 	if (size == UINT_MAX) {
 		free(ptr);
 		return NULL;
 	}
+	alloc_count++;
 	return realloc(ptr, size);
 }
 
@@ -340,6 +347,343 @@ static void test_index_of_05() {
 	vector_destroy(v);
 }
 
+static void test_index_of_06() {
+	vector *v = vector_create(0, 0);
+	int i;
+	for (i = 0; i < 1000; i++) {
+		vector_add(v, i);
+	}
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_EQUAL(i, vector_index_of(v, i));
+	}
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 1000));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, INT_MAX));
+	vector_set(v, 999, 3);
+	CU_ASSERT_EQUAL(3, vector_index_of(v, 3));
+	vector_destroy(v);
+}
+
+#if VECTOR_HAS_SIMD
+static void check_find_kernels(const vector_find_func *kernels, int last) {
+	unsigned char bytes[201] = { 0 };
+	unsigned short shorts[201] = { 0 };
+	unsigned int ints[201] = { 0 };
+	unsigned long long longs[201] = { 0 };
+	float floats[201] = { 0 };
+	double doubles[201] = { 0 };
+	unsigned char byte = 1;
+	unsigned short s = 0x100;
+	unsigned int x = 0x10000;
+	unsigned long long l = 0x100000000ULL;
+	float f = 1.5f, nan_f = 0.0f / 0.0f, minus_zero_f = -0.0f;
+	double d = 1.5, nan_d = 0.0 / 0.0, minus_zero_d = -0.0;
+	size_t n, i;
+	for (n = 0; n <= 200; n += 7) {
+		for (i = 0; i < n; i++) {
+			bytes[i] = byte;
+			shorts[i] = s;
+			ints[i] = x;
+			longs[i] = l;
+			floats[i] = f;
+			doubles[i] = d;
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_8](bytes, n, &byte));
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_16](shorts, n, &s));
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_32](ints, n, &x));
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_64](longs, n, &l));
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_FLOAT](floats, n, &f));
+			CU_ASSERT_EQUAL(i, kernels[VECTOR_FIND_DOUBLE](doubles, n, &d));
+			bytes[n - 1 - i] = byte;
+			ints[n - 1 - i] = x;
+			CU_ASSERT_EQUAL(last ? (i > n - 1 - i ? i : n - 1 - i) : (i < n - 1 - i ? i : n - 1 - i),
+					kernels[VECTOR_FIND_8](bytes, n, &byte));
+			CU_ASSERT_EQUAL(last ? (i > n - 1 - i ? i : n - 1 - i) : (i < n - 1 - i ? i : n - 1 - i),
+					kernels[VECTOR_FIND_32](ints, n, &x));
+			bytes[n - 1 - i] = ints[n - 1 - i] = 0;
+			bytes[i] = shorts[i] = ints[i] = longs[i] = 0;
+			floats[i] = doubles[i] = 0;
+		}
+		ints[n] = x;
+		longs[n] = l;
+		CU_ASSERT_EQUAL((size_t) -1, kernels[VECTOR_FIND_32](ints, n, &x));
+		CU_ASSERT_EQUAL((size_t) -1, kernels[VECTOR_FIND_64](longs, n, &l));
+		ints[n] = 0;
+		longs[n] = 0;
+	}
+	longs[5] = 0x10000;
+	CU_ASSERT_EQUAL((size_t) -1, kernels[VECTOR_FIND_64](longs, 200, &l));
+	floats[150] = nan_f;
+	doubles[150] = nan_d;
+	CU_ASSERT_EQUAL((size_t) -1, kernels[VECTOR_FIND_FLOAT](floats, 200, &nan_f));
+	CU_ASSERT_EQUAL((size_t) -1, kernels[VECTOR_FIND_DOUBLE](doubles, 200, &nan_d));
+	CU_ASSERT_EQUAL(last ? 199 : 0, kernels[VECTOR_FIND_FLOAT](floats, 200, &minus_zero_f));
+	CU_ASSERT_EQUAL(last ? 199 : 0, kernels[VECTOR_FIND_DOUBLE](doubles, 200, &minus_zero_d));
+}
+#endif
+
+static void test_index_of_07() {
+#if VECTOR_HAS_SIMD
+	const vector_find_func sse2[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_sse2_8_internal, vector_find_sse2_16_internal, vector_find_sse2_32_internal,
+			vector_find_sse2_64_internal, vector_find_sse2_float_internal, vector_find_sse2_double_internal },
+		{ vector_find_sse2_8_last_internal, vector_find_sse2_16_last_internal, vector_find_sse2_32_last_internal,
+			vector_find_sse2_64_last_internal, vector_find_sse2_float_last_internal, vector_find_sse2_double_last_internal }
+	};
+	const vector_find_func avx2[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_avx2_8_internal, vector_find_avx2_16_internal, vector_find_avx2_32_internal,
+			vector_find_avx2_64_internal, vector_find_avx2_float_internal, vector_find_avx2_double_internal },
+		{ vector_find_avx2_8_last_internal, vector_find_avx2_16_last_internal, vector_find_avx2_32_last_internal,
+			vector_find_avx2_64_last_internal, vector_find_avx2_float_last_internal, vector_find_avx2_double_last_internal }
+	};
+	const vector_find_func avx512[2][VECTOR_FIND_KINDS] = {
+		{ vector_find_avx512_8_internal, vector_find_avx512_16_internal, vector_find_avx512_32_internal,
+			vector_find_avx512_64_internal, vector_find_avx512_float_internal, vector_find_avx512_double_internal },
+		{ vector_find_avx512_8_last_internal, vector_find_avx512_16_last_internal, vector_find_avx512_32_last_internal,
+			vector_find_avx512_64_last_internal, vector_find_avx512_float_last_internal,
+			vector_find_avx512_double_last_internal }
+	};
+	int last;
+	CU_ASSERT_EQUAL(VECTOR_FIND_32, vector_find_kind_internal(int));
+	CU_ASSERT_EQUAL(VECTOR_FIND_FLOAT, vector_find_kind_internal(float));
+	CU_ASSERT_EQUAL(-1, vector_find_kind_internal(long double));
+	CU_ASSERT_EQUAL(sizeof(void *) == 8 ? VECTOR_FIND_64 : VECTOR_FIND_32, vector_find_kind_internal(char *));
+	for (last = 0; last < 2; last++) {
+		if (__builtin_cpu_supports("sse2")) {
+			check_find_kernels(sse2[last], last);
+		}
+		if (__builtin_cpu_supports("avx2")) {
+			check_find_kernels(avx2[last], last);
+		}
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+			check_find_kernels(avx512[last], last);
+		}
+	}
+#endif
+}
+
+static void test_index_of_from_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i % 10);
+	}
+	CU_ASSERT_EQUAL(3, vector_index_of_from(v, 3, 0));
+	CU_ASSERT_EQUAL(3, vector_index_of_from(v, 3, 3));
+	CU_ASSERT_EQUAL(13, vector_index_of_from(v, 3, 4));
+	CU_ASSERT_EQUAL(93, vector_index_of_from(v, 3, 85));
+	CU_ASSERT_EQUAL(-1, vector_index_of_from(v, 3, 94));
+	CU_ASSERT_EQUAL(-1, vector_index_of_from(v, 3, 100));
+	CU_ASSERT_EQUAL(-1, vector_index_of_from(v, 3, 1000));
+	CU_ASSERT_EQUAL(-1, vector_index_of_from(v, 10, 0));
+	vector_destroy(v);
+}
+
+static void test_last_index_of_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	CU_ASSERT_EQUAL(-1, vector_last_index_of(v, 0));
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i % 10);
+	}
+	CU_ASSERT_EQUAL(93, vector_last_index_of(v, 3));
+	CU_ASSERT_EQUAL(99, vector_last_index_of(v, 9));
+	CU_ASSERT_EQUAL(90, vector_last_index_of(v, 0));
+	CU_ASSERT_EQUAL(-1, vector_last_index_of(v, 10));
+	vector_remove_range(v, 91, 100);
+	CU_ASSERT_EQUAL(90, vector_last_index_of(v, 0));
+	CU_ASSERT_EQUAL(89, vector_last_index_of(v, 9));
+	vector_destroy(v);
+}
+
+static void test_find_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, 0));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_rfind(v, 0));
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i % 10);
+	}
+	CU_ASSERT_EQUAL(3, vector_find(v, 3));
+	CU_ASSERT_EQUAL(93, vector_rfind(v, 3));
+	CU_ASSERT_EQUAL(13, vector_find_from(v, 3, 4));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find_from(v, 3, 94));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find_from(v, 3, 1000));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, 10));
+	vector_destroy(v);
+}
+
+static void test_sort_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	for (i = 0; i < 100; i++) {
+		vector_add(v, (i * 37) % 50);
+	}
+	CU_ASSERT_FALSE(vector_flags(v) & VECTOR_SORTED);
+	vector_sort(v);
+	CU_ASSERT_TRUE(vector_flags(v) & VECTOR_SORTED);
+	for (i = 0; i < 100; i++) {
+		CU_ASSERT_EQUAL(i / 2, vector_get(v, i));
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 100));
+	CU_ASSERT_EQUAL(20, vector_index_of(v, 10));
+	CU_ASSERT_EQUAL(21, vector_last_index_of(v, 10));
+	CU_ASSERT_EQUAL(21, vector_index_of_from(v, 10, 21));
+	CU_ASSERT_EQUAL(-1, vector_index_of_from(v, 10, 22));
+	CU_ASSERT_EQUAL(20, vector_find(v, 10));
+	CU_ASSERT_EQUAL(21, vector_rfind(v, 10));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, 50));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, -1));
+	CU_ASSERT_EQUAL(20, vector_binary_search(v, 10));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_binary_search(v, 50));
+	CU_ASSERT_EQUAL(0, vector_lower_bound(v, -1));
+	CU_ASSERT_EQUAL(20, vector_lower_bound(v, 10));
+	CU_ASSERT_EQUAL(100, vector_lower_bound(v, 50));
+	vector_destroy(v);
+}
+
+static void test_sort_02() {
+	vector *v = vector_create(0, 0);
+	vector_sort(v);
+	CU_ASSERT_TRUE(vector_flags(v) & VECTOR_SORTED);
+	vector_add(v, 1);
+	vector_add(v, 2);
+	vector_insert(v, 1, 2);
+	CU_ASSERT_TRUE(vector_flags(v) & VECTOR_SORTED);
+	vector_remove(v, 0);
+	vector_swap_remove(v, 1);
+	CU_ASSERT_TRUE(vector_flags(v) & VECTOR_SORTED);
+	vector_add(v, 0);
+	CU_ASSERT_FALSE(vector_flags(v) & VECTOR_SORTED);
+	CU_ASSERT_EQUAL(1, vector_index_of(v, 0));
+	vector_sort(v);
+	vector_set(v, 0, 5);
+	CU_ASSERT_FALSE(vector_flags(v) & VECTOR_SORTED);
+	CU_ASSERT_EQUAL(5, vector_get(v, 0));
+	vector_sort(v);
+	vector_add(v, 9);
+	vector_swap_remove(v, 0);
+	CU_ASSERT_FALSE(vector_flags(v) & VECTOR_SORTED);
+	vector_destroy(v);
+}
+
+static void test_insert_sorted_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	vector_sort(v);
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_TRUE(vector_insert_sorted(v, (i * 7919) % 500));
+	}
+	CU_ASSERT_TRUE(vector_flags(v) & VECTOR_SORTED);
+	CU_ASSERT_EQUAL(1000, vector_size(v));
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_EQUAL(i / 2, vector_get(v, i));
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 1000));
+	CU_ASSERT_FALSE(vector_insert_sorted(v, INT_MAX));
+	CU_ASSERT_EQUAL(1000, vector_size(v));
+	vector_destroy(v);
+}
+
+static size_t scalar_find(vector *v, int element, size_t start, int last) {
+	size_t i, result = VECTOR_NPOS;
+	for (i = start; i < vector_size(v); i++) {
+		if (vector_get(v, i) == element) {
+			result = i;
+			if (!last) {
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+static void test_hash_index_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	CU_ASSERT_FALSE(vector_has_hash_index(v));
+	CU_ASSERT_TRUE(vector_enable_hash_index(v));
+	CU_ASSERT_TRUE(vector_has_hash_index(v));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 0));
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_FALSE(vector_contains(v, i));
+		vector_add(v, i);
+	}
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_EQUAL(i, vector_index_of(v, i));
+	}
+	CU_ASSERT_EQUAL(500, vector_set(v, 500, 7));
+	CU_ASSERT_EQUAL(7, vector_index_of(v, 7));
+	CU_ASSERT_EQUAL(500, vector_last_index_of(v, 7));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 500));
+	vector_disable_hash_index(v);
+	CU_ASSERT_FALSE(vector_has_hash_index(v));
+	CU_ASSERT_EQUAL(500, vector_last_index_of(v, 7));
+	vector_destroy(v);
+}
+
+static void test_hash_index_02() {
+	vector *v = vector_create(0, 0);
+	int array[5] = { 1, 2, 3, 4, 5 };
+	int step, value;
+	srand(1);
+	CU_ASSERT_TRUE(vector_enable_hash_index(v));
+	for (step = 0; step < 3000; step++) {
+		size_t size = vector_size(v);
+		size_t index = size ? (size_t) rand() % size : 0;
+		switch (rand() % 12) {
+		case 0:
+		case 1:
+		case 2:
+			vector_add(v, rand() % 64);
+			break;
+		case 3:
+			vector_insert(v, index, rand() % 64);
+			break;
+		case 4:
+			if (size) {
+				vector_remove(v, index);
+			}
+			break;
+		case 5:
+			if (size) {
+				vector_swap_remove(v, index);
+			}
+			break;
+		case 6:
+			if (size) {
+				vector_set(v, index, rand() % 64);
+			}
+			break;
+		case 7:
+			vector_remove_range(v, index, index + (size - index) / 2);
+			break;
+		case 8:
+			vector_remove_range(v, index, size);
+			break;
+		case 9:
+			vector_insert_array(v, index, array, 5);
+			break;
+		case 10:
+			vector_append_n(v, array, 3);
+			break;
+		default:
+			if (rand() % 20 == 0) {
+				vector_clear(v);
+			} else if (rand() % 10 == 0) {
+				vector_sort(v);
+			}
+			break;
+		}
+		for (value = 0; value < 64; value += 3) {
+			size_t start = vector_size(v) ? (size_t) rand() % vector_size(v) : 0;
+			CU_ASSERT_EQUAL(scalar_find(v, value, 0, 0), vector_find(v, value));
+			CU_ASSERT_EQUAL(scalar_find(v, value, 0, 1), vector_rfind(v, value));
+			CU_ASSERT_EQUAL(scalar_find(v, value, start, 0), vector_find_from(v, value, start));
+		}
+	}
+	CU_ASSERT_TRUE(vector_has_hash_index(v));
+	vector_destroy(v);
+}
+
 static void test_contains_01() {
 	vector *v = vector_create(0, 1);
 	CU_ASSERT_FALSE(vector_contains(v, 0));
@@ -388,6 +732,22 @@ static void test_clear_03() {
 	vector_destroy(v);
 }
 
+static void test_clear_04() {
+	vector *v = vector_create(10, 1);
+	int i;
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i);
+	}
+	vector_clear(v);
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 0));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 1));
+	vector_add(v, 123);
+	CU_ASSERT_EQUAL(1, vector_size(v));
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 1));
+	vector_destroy(v);
+}
+
 static void test_to_array_01() {
 	vector *v = vector_create(1, 1);
 	const int *array;
@@ -421,6 +781,26 @@ static void test_append_01() {
 	vector_destroy(v);
 }
 
+static void test_append_n_01() {
+	vector *v = vector_create(1, 1);
+	int array[] = { 1, 2, 3, 4 };
+	int count;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	count = alloc_count;
+	CU_ASSERT_PTR_EQUAL(v, vector_append_n(v, array, 4));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(4, vector_size(v));
+	CU_ASSERT_PTR_EQUAL(v, vector_append_n(v, array, 2));
+	CU_ASSERT_PTR_EQUAL(v, vector_append_n(v, array, 0));
+	CU_ASSERT_EQUAL(6, vector_size(v));
+	CU_ASSERT_EQUAL(1, vector_get(v, 0));
+	CU_ASSERT_EQUAL(4, vector_get(v, 3));
+	CU_ASSERT_EQUAL(1, vector_get(v, 4));
+	CU_ASSERT_EQUAL(2, vector_get(v, 5));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 6));
+	vector_destroy(v);
+}
+
 static void test_concat_01() {
 	vector *v1 = vector_create(1, 1);
 	vector *v2 = vector_create(1, 1);
@@ -469,6 +849,736 @@ static void test_concat_04() {
 	vector_destroy(v2);
 }
 
+static size_t grow_by_ten(size_t capacity, size_t min_capacity) {
+	return capacity + 10;
+}
+
+static void test_set_growth_factor_01() {
+	vector *v = vector_create(1, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_growth_factor(v, 1.5, 0, 0);
+	vector_add(v, 1);
+	CU_ASSERT_EQUAL(2, vector_capacity(v));
+	vector_add(v, 2);
+	CU_ASSERT_EQUAL(3, vector_capacity(v));
+	vector_add(v, 3);
+	CU_ASSERT_EQUAL(4, vector_capacity(v));
+	vector_add(v, 4);
+	CU_ASSERT_EQUAL(6, vector_capacity(v));
+	vector_add(v, 5);
+	vector_add(v, 6);
+	CU_ASSERT_EQUAL(9, vector_capacity(v));
+	vector_destroy(v);
+}
+
+static void test_set_growth_factor_02() {
+	vector *v = vector_create(0, 1);
+	size_t capacity;
+	int i, count = 0;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_growth_factor(v, 2.0, 16, 1024);
+	capacity = vector_capacity(v);
+	for (i = 0; i < 100000; i++) {
+		vector_add(v, i);
+		if (vector_capacity(v) != capacity) {
+			CU_ASSERT_TRUE(vector_capacity(v) - capacity >= 16);
+			CU_ASSERT_TRUE(vector_capacity(v) - capacity <= 1024);
+			capacity = vector_capacity(v);
+			count++;
+		}
+	}
+	CU_ASSERT_EQUAL(100000, vector_size(v));
+	CU_ASSERT_TRUE(count < 120);
+	for (i = 0; i < 100000; i++) {
+		CU_ASSERT_EQUAL(i, vector_get(v, i));
+	}
+	vector_destroy(v);
+}
+
+static void test_set_growth_policy_01() {
+	vector *v = vector_create(1, 1);
+	int array[] = { 2, 3, 4, 5, 6, 7, 8, 9, 10, INT_MAX };
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_growth_factor(v, 2.0, 0, 0);
+	vector_set_growth_policy(v, grow_by_ten);
+	vector_add(v, 1);
+	CU_ASSERT_EQUAL(11, vector_capacity(v));
+	vector_set_growth_policy(v, NULL);
+	vector_set_growth_factor(v, 0, 0, 0);
+	vector_append(v, array);
+	CU_ASSERT_EQUAL(11, vector_capacity(v));
+	vector_add(v, 11);
+	CU_ASSERT_EQUAL(12, vector_capacity(v));
+	vector_destroy(v);
+}
+
+static void test_ensure_capacity_01() {
+	vector *v = vector_create(1, 1);
+	int count;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	count = alloc_count;
+	CU_ASSERT_TRUE(vector_ensure_capacity(v, 1000));
+	CU_ASSERT_EQUAL(1000, vector_capacity(v));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_TRUE(vector_ensure_capacity(v, 10));
+	CU_ASSERT_EQUAL(1000, vector_capacity(v));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 0));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 999));
+	vector_destroy(v);
+}
+
+static void test_reserve_01() {
+	vector *v = vector_create(1, 1);
+	int i, count;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	count = alloc_count;
+	CU_ASSERT_TRUE(vector_reserve(v, 100));
+	CU_ASSERT_EQUAL(102, vector_capacity(v));
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_EQUAL(101, vector_size(v));
+	CU_ASSERT_EQUAL(102, vector_capacity(v));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	CU_ASSERT_EQUAL(99, vector_get(v, 100));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 101));
+	vector_destroy(v);
+}
+
+static void test_set_flags_01() {
+	vector *v = vector_create(1, 1);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(0, vector_flags(v));
+	vector_set_flags(v, VECTOR_SENTINEL_ONLY);
+	CU_ASSERT_EQUAL(VECTOR_SENTINEL_ONLY, vector_flags(v));
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i);
+		CU_ASSERT_EQUAL(INT_MAX, vector_get(v, vector_size(v)));
+	}
+	vector_insert(v, 50, 123);
+	CU_ASSERT_EQUAL(123, vector_get(v, 50));
+	CU_ASSERT_EQUAL(99, vector_get(v, 100));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 101));
+	vector_remove(v, 0);
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 100));
+	CU_ASSERT_TRUE(vector_reserve(v, 1000));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, vector_size(v)));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 0));
+	CU_ASSERT_EQUAL(0, vector_index_of(v, 1));
+	vector_destroy(v);
+}
+
+static void test_trim_to_size_01() {
+	vector *v = vector_create(100, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	vector_add(v, 456);
+	vector_trim_to_size(v);
+	CU_ASSERT_EQUAL(3, vector_capacity(v));
+	CU_ASSERT_EQUAL(2, vector_size(v));
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	CU_ASSERT_EQUAL(456, vector_get(v, 1));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 2));
+	vector_clear(v);
+	vector_trim_to_size(v);
+	CU_ASSERT_EQUAL(1, vector_capacity(v));
+	vector_add(v, 789);
+	CU_ASSERT_EQUAL(789, vector_get(v, 0));
+	vector_destroy(v);
+}
+
+static void test_auto_shrink_01() {
+	vector *v = vector_create(1, 0);
+	size_t capacity;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_AUTO_SHRINK);
+	for (i = 0; i < 1000; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_EQUAL(1024, vector_capacity(v));
+	while (vector_size(v) > 10) {
+		vector_remove(v, 0);
+		CU_ASSERT_TRUE(vector_size(v) + 1 >= vector_capacity(v) / 4);
+	}
+	CU_ASSERT_TRUE(vector_capacity(v) < 64);
+	CU_ASSERT_EQUAL(990, vector_get(v, 0));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, vector_size(v)));
+	capacity = vector_capacity(v);
+	for (i = 0; i < 100; i++) {
+		vector_add(v, i);
+		vector_remove(v, vector_size(v) - 1);
+	}
+	CU_ASSERT_EQUAL(capacity, vector_capacity(v));
+	vector_clear(v);
+	CU_ASSERT_EQUAL(2, vector_capacity(v));
+	vector_destroy(v);
+}
+
+static void test_insert_array_01() {
+	vector *v = vector_create(1, 1);
+	int array[] = { 10, 20, 30 };
+	int i, count;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 5; i++) {
+		vector_add(v, i);
+	}
+	count = alloc_count;
+	CU_ASSERT_TRUE(vector_insert_array(v, 2, array, 3));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(8, vector_size(v));
+	CU_ASSERT_EQUAL(0, vector_get(v, 0));
+	CU_ASSERT_EQUAL(1, vector_get(v, 1));
+	CU_ASSERT_EQUAL(10, vector_get(v, 2));
+	CU_ASSERT_EQUAL(20, vector_get(v, 3));
+	CU_ASSERT_EQUAL(30, vector_get(v, 4));
+	CU_ASSERT_EQUAL(2, vector_get(v, 5));
+	CU_ASSERT_EQUAL(4, vector_get(v, 7));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 8));
+	vector_destroy(v);
+}
+
+static void test_insert_array_02() {
+	vector *v = vector_create(10, 1);
+	int array[] = { 10, 20, 30 };
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_TRUE(vector_insert_array(v, 0, array, 3));
+	CU_ASSERT_TRUE(vector_insert_array(v, 3, array, 1));
+	CU_ASSERT_TRUE(vector_insert_array(v, 0, array + 2, 1));
+	CU_ASSERT_TRUE(vector_insert_array(v, 1, array, 0));
+	CU_ASSERT_FALSE(vector_insert_array(v, 6, array, 1));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_EQUAL(10, vector_capacity(v));
+	CU_ASSERT_EQUAL(30, vector_get(v, 0));
+	CU_ASSERT_EQUAL(10, vector_get(v, 1));
+	CU_ASSERT_EQUAL(20, vector_get(v, 2));
+	CU_ASSERT_EQUAL(30, vector_get(v, 3));
+	CU_ASSERT_EQUAL(10, vector_get(v, 4));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 5));
+	vector_destroy(v);
+}
+
+static void test_remove_range_01() {
+	vector *v = vector_create(1, 1);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 10; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_TRUE(vector_remove_range(v, 0, 3));
+	CU_ASSERT_EQUAL(7, vector_size(v));
+	CU_ASSERT_EQUAL(3, vector_get(v, 0));
+	CU_ASSERT_EQUAL(9, vector_get(v, 6));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 7));
+	CU_ASSERT_TRUE(vector_remove_range(v, 2, 4));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_EQUAL(3, vector_get(v, 0));
+	CU_ASSERT_EQUAL(4, vector_get(v, 1));
+	CU_ASSERT_EQUAL(7, vector_get(v, 2));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 5));
+	CU_ASSERT_TRUE(vector_remove_range(v, 1, 1));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_FALSE(vector_remove_range(v, 3, 2));
+	CU_ASSERT_FALSE(vector_remove_range(v, 3, 6));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_TRUE(vector_remove_range(v, 3, 5));
+	CU_ASSERT_EQUAL(3, vector_size(v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 3));
+	CU_ASSERT_TRUE(vector_remove_range(v, 0, vector_size(v)));
+	CU_ASSERT_TRUE(vector_is_empty(v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 0));
+	vector_destroy(v);
+}
+
+static void test_swap_remove_01() {
+	vector *v = vector_create(1, 1);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 5; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_EQUAL(1, vector_swap_remove(v, 1));
+	CU_ASSERT_EQUAL(4, vector_size(v));
+	CU_ASSERT_EQUAL(0, vector_get(v, 0));
+	CU_ASSERT_EQUAL(4, vector_get(v, 1));
+	CU_ASSERT_EQUAL(2, vector_get(v, 2));
+	CU_ASSERT_EQUAL(3, vector_get(v, 3));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 4));
+	CU_ASSERT_EQUAL(3, vector_swap_remove(v, 3));
+	CU_ASSERT_EQUAL(3, vector_size(v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 3));
+	while (!vector_is_empty(v)) {
+		vector_swap_remove(v, 0);
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 0));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 0));
+	vector_destroy(v);
+}
+
+static void test_concat_05() {
+	vector *v = vector_create(1, 1);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 3; i++) {
+		vector_add(v, i);
+	}
+	vector_concat(v, v);
+	CU_ASSERT_EQUAL(6, vector_size(v));
+	for (i = 0; i < 6; i++) {
+		CU_ASSERT_EQUAL(i % 3, vector_get(v, i));
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 6));
+	vector_destroy(v);
+}
+
+static void test_detach_01() {
+	vector *v = vector_create(10, 1);
+	int *array;
+	size_t size = 0;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	vector_add(v, 456);
+	array = vector_detach(v, &size);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	CU_ASSERT_EQUAL(2, size);
+	CU_ASSERT_EQUAL(123, array[0]);
+	CU_ASSERT_EQUAL(456, array[1]);
+	CU_ASSERT_EQUAL(INT_MAX, array[2]);
+	CU_ASSERT_TRUE(vector_is_empty(v));
+	CU_ASSERT_EQUAL(1, vector_capacity(v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 0));
+	vector_add(v, 789);
+	CU_ASSERT_EQUAL(789, vector_get(v, 0));
+	CU_ASSERT_EQUAL(123, array[0]);
+	vector_alloc(array, UINT_MAX);
+	vector_destroy(v);
+}
+
+static void test_adopt_01() {
+	int *array = (int *) vector_alloc(NULL, 4 * sizeof(int));
+	vector *v;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	array[0] = 1;
+	array[1] = 2;
+	CU_ASSERT_PTR_NULL(vector_adopt(array, 4, 4));
+	CU_ASSERT_PTR_NULL(vector_adopt(NULL, 0, 4));
+	v = vector_adopt(array, 2, 4);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_PTR_EQUAL(array, vector_to_array(v));
+	CU_ASSERT_EQUAL(2, vector_size(v));
+	CU_ASSERT_EQUAL(4, vector_capacity(v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 2));
+	vector_add(v, 3);
+	vector_add(v, 4);
+	CU_ASSERT_EQUAL(4, vector_size(v));
+	CU_ASSERT_EQUAL(8, vector_capacity(v));
+	CU_ASSERT_EQUAL(1, vector_get(v, 0));
+	CU_ASSERT_EQUAL(4, vector_get(v, 3));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 4));
+	vector_destroy(v);
+}
+
+static void test_reserve_back_01() {
+	vector *v = vector_create(1, 1);
+	int *slots;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	slots = vector_reserve_back(v, 10);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(slots);
+	CU_ASSERT_TRUE(vector_capacity(v) >= 12);
+	CU_ASSERT_EQUAL(1, vector_size(v));
+	for (i = 0; i < 10; i++) {
+		slots[i] = i;
+	}
+	CU_ASSERT_TRUE(vector_commit(v, 4));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	CU_ASSERT_EQUAL(0, vector_get(v, 1));
+	CU_ASSERT_EQUAL(3, vector_get(v, 4));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 5));
+	CU_ASSERT_FALSE(vector_commit(v, vector_capacity(v)));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	CU_ASSERT_TRUE(vector_commit(v, 0));
+	CU_ASSERT_EQUAL(5, vector_size(v));
+	vector_destroy(v);
+}
+
+static void test_arena_alloc_01() {
+	vector_arena arena;
+	char *p1, *p2, *p3;
+	CU_ASSERT_TRUE_FATAL(vector_arena_init(&arena, NULL, 1024));
+	p1 = (char *) vector_arena_alloc(&arena, NULL, 10);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p1);
+	CU_ASSERT_EQUAL(0, (size_t) p1 % sizeof(vector_arena_block));
+	CU_ASSERT_EQUAL(0, (size_t) p1 % sizeof(long double));
+	strcpy(p1, "arena");
+	p2 = (char *) vector_arena_alloc(&arena, p1, 100);
+	CU_ASSERT_PTR_EQUAL(p1, p2);
+	p3 = (char *) vector_arena_alloc(&arena, NULL, 10);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p3);
+	CU_ASSERT_TRUE(p3 >= p2 + 100);
+	p2 = (char *) vector_arena_alloc(&arena, p1, 200);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p2);
+	CU_ASSERT_PTR_NOT_EQUAL(p1, p2);
+	CU_ASSERT_STRING_EQUAL("arena", p2);
+	CU_ASSERT_PTR_NULL(vector_arena_alloc(&arena, NULL, 1024));
+	CU_ASSERT_PTR_NULL(vector_arena_alloc(&arena, p2, UINT_MAX));
+	CU_ASSERT_PTR_EQUAL(p2, vector_arena_alloc(&arena, NULL, 10));
+	vector_arena_reset(&arena);
+	CU_ASSERT_PTR_EQUAL(p1, vector_arena_alloc(&arena, NULL, 10));
+	vector_arena_destroy(&arena);
+}
+
+static void test_arena_alloc_02() {
+	vector_arena arena;
+	char *p1, *p2;
+	CU_ASSERT_TRUE_FATAL(vector_arena_init(&arena, NULL, 1024));
+	CU_ASSERT_PTR_NULL(vector_arena_alloc(&arena, NULL, UINT_MAX));
+	p1 = (char *) vector_arena_alloc(&arena, NULL, 10);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p1);
+	CU_ASSERT_EQUAL(0, (size_t) p1 % sizeof(long double));
+	CU_ASSERT_PTR_NULL(vector_arena_alloc(&arena, NULL, UINT_MAX));
+	p2 = (char *) vector_arena_alloc(&arena, NULL, 10);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(p2);
+	CU_ASSERT_TRUE(p2 >= p1 + 10);
+	vector_arena_reset(&arena);
+	CU_ASSERT_PTR_EQUAL(p1, vector_arena_alloc(&arena, NULL, 10));
+	vector_arena_destroy(&arena);
+}
+
+static void *counting_alloc(void *context, void *ptr, size_t size) {
+	++*(int *) context;
+	return vector_alloc(ptr, size);
+}
+
+static const vector_allocator counting_allocator = { counting_alloc };
+
+static void test_create_with_allocator_01() {
+	int count = 0;
+	vector *v = vector_create_with_allocator(1, 1, &counting_allocator, &count);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(3, count);
+	vector_add(v, 123);
+	CU_ASSERT_EQUAL(4, count);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	vector_destroy(v);
+	CU_ASSERT_EQUAL(7, count);
+}
+
+static void test_create_with_allocator_02() {
+	vector_arena arena;
+	vector *v1, *v2;
+	int i, count;
+	CU_ASSERT_TRUE_FATAL(vector_arena_init(&arena, NULL, 64 * 1024));
+	v1 = vector_create_with_allocator(0, 0, &vector_arena_allocator, &arena);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v1);
+	count = alloc_count;
+	for (i = 0; i < 1000; i++) {
+		vector_add(v1, i);
+	}
+	CU_ASSERT_EQUAL(count, alloc_count);
+	CU_ASSERT_TRUE((char *) vector_to_array(v1) >= arena.buffer);
+	CU_ASSERT_TRUE((char *) vector_to_array(v1) < arena.buffer + arena.size);
+	v2 = vector_create_with_allocator(0, 0, &vector_arena_allocator, &arena);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v2);
+	vector_concat(v2, v1);
+	CU_ASSERT_EQUAL(1000, vector_size(v2));
+	CU_ASSERT_EQUAL(999, vector_get(v2, 999));
+	CU_ASSERT_FALSE(vector_reserve(v2, 64 * 1024));
+	CU_ASSERT_EQUAL(999, vector_get(v2, 999));
+	vector_arena_reset(&arena);
+	CU_ASSERT_EQUAL(0, arena.used);
+	vector_arena_destroy(&arena);
+}
+
+static void test_create_compact_01() {
+	vector *v;
+	int i, count = alloc_count;
+	v = vector_create_compact(4, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(4, vector_capacity(v));
+	CU_ASSERT_TRUE((char *) vector_to_array(v) > (char *) v);
+	CU_ASSERT_TRUE((char *) vector_to_array(v) < (char *) v + sizeof(vector) + sizeof(int));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 3));
+	for (i = 0; i < 3; i++) {
+		vector_add(v, i);
+	}
+	vector_trim_to_size(v);
+	CU_ASSERT_EQUAL(4, vector_capacity(v));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	for (; i < 10; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_EQUAL(10, vector_size(v));
+	for (i = 0; i < 10; i++) {
+		CU_ASSERT_EQUAL(i, vector_get(v, i));
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 10));
+	vector_destroy(v);
+}
+
+static void test_create_compact_02() {
+	vector *v = vector_create_compact(0, 1);
+	int *array;
+	size_t size = 0;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(1, vector_capacity(v));
+	vector_add(v, 123);
+	vector_destroy(v);
+	v = vector_create_compact(10, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	vector_add(v, 456);
+	array = vector_detach(v, &size);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	CU_ASSERT_EQUAL(2, size);
+	CU_ASSERT_EQUAL(123, array[0]);
+	CU_ASSERT_EQUAL(456, array[1]);
+	CU_ASSERT_EQUAL(INT_MAX, array[2]);
+	CU_ASSERT_TRUE(vector_is_empty(v));
+	vector_add(v, 789);
+	CU_ASSERT_EQUAL(789, vector_get(v, 0));
+	vector_alloc(array, UINT_MAX);
+	vector_destroy(v);
+}
+
+static void test_init_inplace_01() {
+	vector v;
+	int i, count = alloc_count;
+	CU_ASSERT_TRUE_FATAL(vector_init_inplace(&v, 4, 0));
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(0, vector_size(&v));
+	CU_ASSERT_EQUAL(4, vector_capacity(&v));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(&v, 0));
+	for (i = 0; i < 100; i++) {
+		vector_add(&v, i);
+	}
+	CU_ASSERT_EQUAL(100, vector_size(&v));
+	CU_ASSERT_EQUAL(50, vector_index_of(&v, 50));
+	vector_fini(&v);
+	CU_ASSERT_PTR_NULL(v.elements);
+}
+
+static void test_set_alignment_01() {
+	vector *v = vector_create(3, 1);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 0);
+	vector_add(v, 1);
+	CU_ASSERT_FALSE(vector_set_alignment(v, 48));
+	CU_ASSERT_TRUE(vector_set_alignment(v, 64));
+	CU_ASSERT_TRUE(vector_alignment(v) >= 64);
+	CU_ASSERT_EQUAL(2, vector_size(v));
+	CU_ASSERT_EQUAL(3, vector_capacity(v));
+	CU_ASSERT_EQUAL(0, vector_get(v, 0));
+	CU_ASSERT_EQUAL(1, vector_get(v, 1));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 2));
+	for (i = 2; i < 1000; i++) {
+		vector_add(v, i);
+		CU_ASSERT_TRUE(vector_alignment(v) >= 64);
+	}
+	for (i = 0; i < 1000; i++) {
+		CU_ASSERT_EQUAL(i, vector_get(v, i));
+	}
+	vector_remove_range(v, 10, 1000);
+	vector_trim_to_size(v);
+	CU_ASSERT_TRUE(vector_alignment(v) >= 64);
+	CU_ASSERT_EQUAL(11, vector_capacity(v));
+	CU_ASSERT_EQUAL(9, vector_get(v, 9));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 10));
+	vector_destroy(v);
+}
+
+static void test_set_alignment_02() {
+	vector *v = vector_create_compact(4, 0);
+	int *array;
+	size_t size = 0;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	CU_ASSERT_TRUE(vector_set_alignment(v, 4096));
+	CU_ASSERT_TRUE(vector_alignment(v) >= 4096);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	array = vector_detach(v, &size);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	CU_ASSERT_EQUAL(1, size);
+	CU_ASSERT_EQUAL(123, array[0]);
+	vector_alloc(array, UINT_MAX);
+	CU_ASSERT_TRUE(vector_set_alignment(v, 0));
+	vector_add(v, 456);
+	vector_reserve(v, 100);
+	CU_ASSERT_EQUAL(456, vector_get(v, 0));
+	vector_destroy(v);
+}
+
+static void test_mmap_01() {
+	vector *v = vector_create(1, 0);
+	const int *array;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_MMAP | VECTOR_SENTINEL_ONLY);
+	for (i = 0; i < 100000; i++) {
+		vector_add(v, i);
+	}
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_MMAP, v->storage);
+	CU_ASSERT_TRUE(vector_alignment(v) >= 4096);
+#endif
+	array = vector_to_array(v);
+	for (i = 0; i < 100000; i++) {
+		CU_ASSERT_EQUAL(i, array[i]);
+	}
+	CU_ASSERT_EQUAL(INT_MAX, array[100000]);
+	CU_ASSERT_TRUE(vector_reserve(v, 1000000));
+	CU_ASSERT_EQUAL(99999, vector_get(v, 99999));
+	vector_remove_range(v, 10, vector_size(v));
+	vector_trim_to_size(v);
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_ALLOC, v->storage);
+	CU_ASSERT_EQUAL(0, vector_huge_pages(v));
+	CU_ASSERT_EQUAL(11, vector_capacity(v));
+	CU_ASSERT_EQUAL(9, vector_get(v, 9));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 10));
+	vector_destroy(v);
+}
+
+static void test_mmap_02() {
+	vector *v = vector_create(1, 0);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_MMAP);
+	for (i = 0; i < 100000; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_TRUE(vector_set_alignment(v, 8192));
+	CU_ASSERT_NOT_EQUAL(VECTOR_STORAGE_MMAP, v->storage);
+	CU_ASSERT_TRUE(vector_alignment(v) >= 8192);
+	CU_ASSERT_TRUE(vector_reserve(v, 1000000));
+	CU_ASSERT_TRUE(vector_alignment(v) >= 8192);
+	CU_ASSERT_EQUAL(99999, vector_get(v, 99999));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 100000));
+	vector_destroy(v);
+}
+
+static void test_mmap_03() {
+	vector *v = vector_create(1, 0);
+	size_t size;
+	int *array;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_MMAP | VECTOR_SENTINEL_ONLY);
+	for (i = 0; i < 100000; i++) {
+		vector_add(v, i);
+	}
+	array = vector_detach(v, &size);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	CU_ASSERT_EQUAL(100000, size);
+	CU_ASSERT_EQUAL(99999, array[99999]);
+	CU_ASSERT_EQUAL(INT_MAX, array[100000]);
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_ALLOC, v->storage);
+	CU_ASSERT_EQUAL(1, vector_capacity(v));
+	CU_ASSERT_EQUAL(0, vector_size(v));
+	vector_alloc(array, UINT_MAX);
+	vector_add(v, 123);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	vector_destroy(v);
+}
+
+static void test_huge_pages_01() {
+	vector *v = vector_create(1, 0);
+	const int *array;
+	size_t n = VECTOR_HUGE_PAGE_SIZE / sizeof(int) * 2;
+	size_t i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_HUGE_PAGES);
+	for (i = 0; i < n; i++) {
+		vector_add(v, (int) i);
+	}
+	CU_ASSERT_EQUAL(0, vector_huge_pages(v) % VECTOR_HUGE_PAGE_SIZE);
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_HUGE_PAGES, v->storage);
+	CU_ASSERT_TRUE(vector_alignment(v) >= VECTOR_HUGE_PAGE_SIZE);
+#endif
+	CU_ASSERT_TRUE(vector_reserve(v, n * 2));
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_TRUE(vector_alignment(v) >= VECTOR_HUGE_PAGE_SIZE);
+#endif
+	array = vector_to_array(v);
+	for (i = 0; i < n; i++) {
+		CU_ASSERT_EQUAL((int) i, array[i]);
+	}
+	CU_ASSERT_EQUAL(INT_MAX, array[n]);
+	CU_ASSERT_EQUAL(INT_MAX, array[vector_capacity(v) - 1]);
+	vector_remove_range(v, 10, vector_size(v));
+	vector_trim_to_size(v);
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_ALLOC, v->storage);
+	CU_ASSERT_EQUAL(0, vector_huge_pages(v));
+	CU_ASSERT_EQUAL(11, vector_capacity(v));
+	CU_ASSERT_EQUAL(9, vector_get(v, 9));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 10));
+	vector_destroy(v);
+}
+
+static void test_huge_pages_02() {
+	vector *v = vector_create(10, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_HUGE_PAGES);
+	vector_add(v, 1);
+	CU_ASSERT_EQUAL(0, vector_huge_pages(v));
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_ALLOC, v->storage);
+	vector_destroy(v);
+}
+
+static void test_huge_pages_03() {
+	vector *v = vector_create(1, 0);
+	size_t n = VECTOR_HUGE_PAGES_THRESHOLD / sizeof(int) * 2;
+	size_t i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_set_flags(v, VECTOR_MMAP | VECTOR_HUGE_PAGES);
+	for (i = 0; i < VECTOR_MMAP_THRESHOLD / sizeof(int); i++) {
+		vector_add(v, (int) i);
+	}
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_MMAP, v->storage);
+#endif
+	CU_ASSERT_TRUE(vector_reserve(v, n));
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_HUGE_PAGES, v->storage);
+	CU_ASSERT_TRUE(vector_alignment(v) >= VECTOR_HUGE_PAGE_SIZE);
+#endif
+	for (i = 0; i < VECTOR_MMAP_THRESHOLD / sizeof(int); i++) {
+		CU_ASSERT_EQUAL((int) i, vector_get(v, i));
+	}
+	vector_trim_to_size(v);
+#if VECTOR_HAS_MMAP
+	CU_ASSERT_EQUAL(VECTOR_STORAGE_MMAP, v->storage);
+#endif
+	CU_ASSERT_EQUAL(INT_MAX, vector_to_array(v)[vector_size(v)]);
+	vector_destroy(v);
+}
+
+static void test_sizeof_01() {
+	vector *v;
+	int count = alloc_count;
+	/* 48 bytes on LP64 */
+	CU_ASSERT_EQUAL(3 * sizeof(size_t) + 2 * sizeof(unsigned int) + 2 * sizeof(void *), sizeof(vector));
+	v = vector_create(0, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(count + 2, alloc_count);
+	CU_ASSERT_PTR_NULL(v->extension);
+	CU_ASSERT_TRUE(vector_set_growth_factor(v, 1.5, 0, 0));
+	CU_ASSERT_PTR_NOT_NULL(v->extension);
+	CU_ASSERT_EQUAL(count + 3, alloc_count);
+	vector_destroy(v);
+}
+
+void add_small_tests(CU_pSuite suite);
+void add_large_tests(CU_pSuite suite);
+
 int main(int argc, char *argv[]) {
 	CU_pSuite suite;
 	CU_initialize_registry();
@@ -502,17 +1612,63 @@ int main(int argc, char *argv[]) {
 	CU_add_test(suite, "test_index_of_03", test_index_of_03);
 	CU_add_test(suite, "test_index_of_04", test_index_of_04);
 	CU_add_test(suite, "test_index_of_05", test_index_of_05);
+	CU_add_test(suite, "test_index_of_06", test_index_of_06);
+	CU_add_test(suite, "test_index_of_07", test_index_of_07);
+	CU_add_test(suite, "test_index_of_from_01", test_index_of_from_01);
+	CU_add_test(suite, "test_last_index_of_01", test_last_index_of_01);
+	CU_add_test(suite, "test_find_01", test_find_01);
+	CU_add_test(suite, "test_sort_01", test_sort_01);
+	CU_add_test(suite, "test_sort_02", test_sort_02);
+	CU_add_test(suite, "test_insert_sorted_01", test_insert_sorted_01);
+	CU_add_test(suite, "test_hash_index_01", test_hash_index_01);
+	CU_add_test(suite, "test_hash_index_02", test_hash_index_02);
 	CU_add_test(suite, "test_contains_01", test_contains_01);
 	CU_add_test(suite, "test_contains_02", test_contains_02);
 	CU_add_test(suite, "test_clear_01", test_clear_01);
 	CU_add_test(suite, "test_clear_02", test_clear_02);
 	CU_add_test(suite, "test_clear_03", test_clear_03);
+	CU_add_test(suite, "test_clear_04", test_clear_04);
 	CU_add_test(suite, "test_to_array_01", test_to_array_01);
 	CU_add_test(suite, "test_append_01", test_append_01);
+	CU_add_test(suite, "test_append_n_01", test_append_n_01);
 	CU_add_test(suite, "test_concat_01", test_concat_01);
 	CU_add_test(suite, "test_concat_02", test_concat_02);
 	CU_add_test(suite, "test_concat_03", test_concat_03);
 	CU_add_test(suite, "test_concat_04", test_concat_04);
+	CU_add_test(suite, "test_concat_05", test_concat_05);
+	CU_add_test(suite, "test_set_growth_factor_01", test_set_growth_factor_01);
+	CU_add_test(suite, "test_set_growth_factor_02", test_set_growth_factor_02);
+	CU_add_test(suite, "test_set_growth_policy_01", test_set_growth_policy_01);
+	CU_add_test(suite, "test_ensure_capacity_01", test_ensure_capacity_01);
+	CU_add_test(suite, "test_reserve_01", test_reserve_01);
+	CU_add_test(suite, "test_set_flags_01", test_set_flags_01);
+	CU_add_test(suite, "test_trim_to_size_01", test_trim_to_size_01);
+	CU_add_test(suite, "test_auto_shrink_01", test_auto_shrink_01);
+	CU_add_test(suite, "test_insert_array_01", test_insert_array_01);
+	CU_add_test(suite, "test_insert_array_02", test_insert_array_02);
+	CU_add_test(suite, "test_remove_range_01", test_remove_range_01);
+	CU_add_test(suite, "test_swap_remove_01", test_swap_remove_01);
+	CU_add_test(suite, "test_detach_01", test_detach_01);
+	CU_add_test(suite, "test_adopt_01", test_adopt_01);
+	CU_add_test(suite, "test_reserve_back_01", test_reserve_back_01);
+	CU_add_test(suite, "test_arena_alloc_01", test_arena_alloc_01);
+	CU_add_test(suite, "test_arena_alloc_02", test_arena_alloc_02);
+	CU_add_test(suite, "test_create_with_allocator_01", test_create_with_allocator_01);
+	CU_add_test(suite, "test_create_with_allocator_02", test_create_with_allocator_02);
+	CU_add_test(suite, "test_create_compact_01", test_create_compact_01);
+	CU_add_test(suite, "test_create_compact_02", test_create_compact_02);
+	CU_add_test(suite, "test_init_inplace_01", test_init_inplace_01);
+	CU_add_test(suite, "test_set_alignment_01", test_set_alignment_01);
+	CU_add_test(suite, "test_set_alignment_02", test_set_alignment_02);
+	CU_add_test(suite, "test_mmap_01", test_mmap_01);
+	CU_add_test(suite, "test_mmap_02", test_mmap_02);
+	CU_add_test(suite, "test_mmap_03", test_mmap_03);
+	CU_add_test(suite, "test_huge_pages_01", test_huge_pages_01);
+	CU_add_test(suite, "test_huge_pages_02", test_huge_pages_02);
+	CU_add_test(suite, "test_huge_pages_03", test_huge_pages_03);
+	CU_add_test(suite, "test_sizeof_01", test_sizeof_01);
+	add_small_tests(suite);
+	add_large_tests(suite);
 	CU_console_run_tests();
 	CU_cleanup_registry();
 	return EXIT_SUCCESS;
@@ -0,0 +1,34 @@
+/*
+ * Checks that vector.h and vector_arena.h compile as C++.
+ * This file is compiled by make cxx_check, and it is not linked into the test
+ * program.
+ */
+#include <climits>
+#include <cstdlib>
+
+#include "vector.h"
+#include "vector_arena.h"
+
+vector_init(float, -1.0f);
+
+static void *vector_alloc(void *ptr, size_t size) {
+	if (size == UINT_MAX) {
+		free(ptr);
+		return NULL;
+	}
+	return realloc(ptr, size);
+}
+
+int test_cxx_contains(float element) {
+	vector *v = vector_create(0, 0);
+	int result;
+	if (v == NULL) {
+		return 0;
+	}
+	vector_add(v, 1.5f);
+	vector_sort(v);
+	vector_enable_hash_index(v);
+	result = vector_contains(v, element) && vector_find(v, element) == 0;
+	vector_destroy(v);
+	return result;
+}
@@ -0,0 +1,35 @@
+/*
+ * Checks that vector.h and vector_arena.h compile as C++ when they are
+ * included inside an extern "C" block.
+ * This file is compiled by make cxx_check, and it is not linked into the test
+ * program.
+ */
+#include <climits>
+#include <cstdlib>
+
+extern "C" {
+#include "vector.h"
+#include "vector_arena.h"
+}
+
+vector_init(double, -1.0);
+
+static void *vector_alloc(void *ptr, size_t size) {
+	if (size == UINT_MAX) {
+		free(ptr);
+		return NULL;
+	}
+	return realloc(ptr, size);
+}
+
+int test_cxx_extern_c_contains(double element) {
+	vector *v = vector_create(0, 0);
+	int result;
+	if (v == NULL) {
+		return 0;
+	}
+	vector_add(v, 1.5);
+	result = vector_contains(v, element);
+	vector_destroy(v);
+	return result;
+}
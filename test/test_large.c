@@ -0,0 +1,72 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include <CUnit.h>
+
+#include "vector.h"
+
+vector_init(unsigned char, UCHAR_MAX);
+
+static void *vector_alloc(void *ptr, size_t size) {
+	if (size == UINT_MAX) {
+		free(ptr);
+		return NULL;
+	}
+	return realloc(ptr, size);
+}
+
+#define LARGE_SIZE (((size_t) 1 << 31) + 16)
+#define LARGE_INDEX (((size_t) 1 << 31) + 5)
+
+/*
+ * Creates a vector of more than 2^31 zero bytes. The pages are mapped by
+ * VECTOR_MMAP and left untouched, so they cost no memory until they are
+ * written. Returns NULL if the system cannot map them.
+ */
+static vector *create_large_vector(void) {
+	vector *v;
+	if (sizeof(size_t) < 8) {
+		return NULL;
+	}
+	v = vector_create(1, 0);
+	if (v == NULL) {
+		return NULL;
+	}
+	vector_set_flags(v, VECTOR_MMAP | VECTOR_SENTINEL_ONLY);
+	if (vector_reserve_back(v, LARGE_SIZE) == NULL) {
+		vector_destroy(v);
+		return NULL;
+	}
+	vector_commit(v, LARGE_SIZE);
+	v->elements[0] = 0;
+	return v;
+}
+
+static void test_large_find_01() {
+	vector *v = create_large_vector();
+	if (v == NULL) {
+		fprintf(stderr, "skipped test_large_find_01: cannot allocate %lu bytes\n", (unsigned long) LARGE_SIZE);
+		return;
+	}
+	CU_ASSERT_EQUAL(LARGE_SIZE, vector_size(v));
+	v->elements[LARGE_INDEX] = 1;
+	CU_ASSERT_EQUAL(LARGE_INDEX, vector_find(v, 1));
+	CU_ASSERT_EQUAL(LARGE_INDEX, vector_rfind(v, 1));
+	CU_ASSERT_EQUAL(-1, vector_index_of(v, 1));
+	CU_ASSERT_TRUE(vector_contains(v, 1));
+	v->elements[5] = 1;
+	CU_ASSERT_EQUAL(5, vector_find(v, 1));
+	CU_ASSERT_EQUAL(LARGE_INDEX, vector_find_from(v, 1, 6));
+	CU_ASSERT_EQUAL(LARGE_INDEX, vector_rfind(v, 1));
+	CU_ASSERT_EQUAL(5, vector_last_index_of(v, 1));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find_from(v, 1, LARGE_INDEX + 1));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, 2));
+	CU_ASSERT_EQUAL(VECTOR_NPOS, vector_find(v, UCHAR_MAX));
+	vector_destroy(v);
+}
+
+void add_large_tests(CU_pSuite suite) {
+	CU_add_test(suite, "test_large_find_01", test_large_find_01);
+}
@@ -0,0 +1,151 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include <CUnit.h>
+
+#include "vector.h"
+
+vector_init_small(int, INT_MAX, 7);
+
+static int alloc_count;
+
+static void *vector_alloc(void *ptr, size_t size) {
+	if (size == UINT_MAX) {
+		free(ptr);
+		return NULL;
+	}
+	alloc_count++;
+	return realloc(ptr, size);
+}
+
+static void test_small_create_01() {
+	vector *v;
+	int i, count = alloc_count;
+	v = vector_create(0, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(8, vector_capacity(v));
+	CU_ASSERT_PTR_EQUAL(v->small_elements, vector_to_array(v));
+	for (i = 0; i < 7; i++) {
+		vector_add(v, i);
+	}
+	CU_ASSERT_EQUAL(count + 1, alloc_count);
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 7));
+	vector_add(v, 7);
+	CU_ASSERT_EQUAL(count + 2, alloc_count);
+	CU_ASSERT_PTR_NOT_EQUAL(v->small_elements, vector_to_array(v));
+	for (i = 0; i < 8; i++) {
+		CU_ASSERT_EQUAL(i, vector_get(v, i));
+	}
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 8));
+	vector_destroy(v);
+}
+
+static void test_small_create_02() {
+	vector *v = vector_create(100, 1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(100, vector_capacity(v));
+	CU_ASSERT_PTR_NOT_EQUAL(v->small_elements, vector_to_array(v));
+	vector_destroy(v);
+}
+
+static void test_small_trim_to_size_01() {
+	vector *v = vector_create(0, 0);
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 20; i++) {
+		vector_add(v, i);
+	}
+	vector_remove_range(v, 3, 20);
+	vector_trim_to_size(v);
+	CU_ASSERT_PTR_EQUAL(v->small_elements, vector_to_array(v));
+	CU_ASSERT_EQUAL(8, vector_capacity(v));
+	CU_ASSERT_EQUAL(3, vector_size(v));
+	CU_ASSERT_EQUAL(0, vector_get(v, 0));
+	CU_ASSERT_EQUAL(2, vector_get(v, 2));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 3));
+	vector_destroy(v);
+}
+
+static void test_small_detach_01() {
+	vector *v = vector_create(0, 0);
+	int *array;
+	size_t size = 0;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	for (i = 0; i < 20; i++) {
+		vector_add(v, i);
+	}
+	array = vector_detach(v, &size);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	CU_ASSERT_EQUAL(20, size);
+	CU_ASSERT_EQUAL(19, array[19]);
+	CU_ASSERT_PTR_EQUAL(v->small_elements, vector_to_array(v));
+	CU_ASSERT_TRUE(vector_is_empty(v));
+	vector_add(v, 123);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	vector_alloc(array, UINT_MAX);
+	vector_destroy(v);
+}
+
+static void test_small_init_inplace_01() {
+	vector v;
+	int count = alloc_count;
+	CU_ASSERT_TRUE_FATAL(vector_init_inplace(&v, 0, 0));
+	vector_add(&v, 123);
+	vector_add(&v, 456);
+	CU_ASSERT_EQUAL(count, alloc_count);
+	CU_ASSERT_EQUAL(1, vector_index_of(&v, 456));
+	vector_fini(&v);
+}
+
+static void test_small_set_alignment_01() {
+	vector *v = vector_create(0, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	vector_add(v, 123);
+	CU_ASSERT_TRUE(vector_set_alignment(v, 256));
+	CU_ASSERT_TRUE(vector_alignment(v) >= 256);
+	vector_trim_to_size(v);
+	CU_ASSERT_TRUE(vector_alignment(v) >= 256);
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	CU_ASSERT_EQUAL(INT_MAX, vector_get(v, 1));
+	vector_destroy(v);
+}
+
+static void test_small_sizeof_01() {
+	/* 80 bytes on LP64 */
+	CU_ASSERT_EQUAL(3 * sizeof(size_t) + 2 * sizeof(unsigned int) + 2 * sizeof(void *) + 8 * sizeof(int),
+			sizeof(vector));
+}
+
+static void test_small_adopt_01() {
+	int *array = (int *) vector_alloc(NULL, 2 * sizeof(int));
+	vector *v;
+	int i;
+	CU_ASSERT_PTR_NOT_NULL_FATAL(array);
+	array[0] = 123;
+	v = vector_adopt(array, 1, 2);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_TRUE(vector_ensure_capacity(v, 5));
+	CU_ASSERT_PTR_EQUAL(v->small_elements, vector_to_array(v));
+	CU_ASSERT_EQUAL(8, vector_capacity(v));
+	CU_ASSERT_EQUAL(1, vector_size(v));
+	CU_ASSERT_EQUAL(123, vector_get(v, 0));
+	for (i = 1; i < 8; i++) {
+		CU_ASSERT_EQUAL(INT_MAX, vector_get(v, i));
+	}
+	vector_destroy(v);
+}
+
+void add_small_tests(CU_pSuite suite) {
+	CU_add_test(suite, "test_small_create_01", test_small_create_01);
+	CU_add_test(suite, "test_small_create_02", test_small_create_02);
+	CU_add_test(suite, "test_small_trim_to_size_01", test_small_trim_to_size_01);
+	CU_add_test(suite, "test_small_detach_01", test_small_detach_01);
+	CU_add_test(suite, "test_small_init_inplace_01", test_small_init_inplace_01);
+	CU_add_test(suite, "test_small_set_alignment_01", test_small_set_alignment_01);
+	CU_add_test(suite, "test_small_adopt_01", test_small_adopt_01);
+	CU_add_test(suite, "test_small_sizeof_01", test_small_sizeof_01);
+}